@@ -0,0 +1,158 @@
+// The C side of the cross-binding benchmark (see compare.py), and the
+// baseline the other bindings are measured against.
+//
+// usage: tree-sitter-lean-bindings-bench [-n iterations] path...
+//
+// Prints one JSON line per file and operation, in the format shared by every
+// script of bench/bindings. There is no `batch` entry point on the C side.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "files.h"
+#include "json.h"
+#include "outline.h"
+
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// keeps the reads of the walk from being optimized away
+static volatile uint32_t sink;
+
+// A pre-order walk with one cursor, reading what a consumer of the tree would.
+static uint32_t walk(TSTree *tree) {
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  uint32_t nodes = 0;
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    sink += ts_node_symbol(node) + ts_node_start_byte(node) +
+            ts_node_end_byte(node);
+    nodes++;
+    if (ts_tree_cursor_goto_first_child(&cursor))
+      continue;
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return nodes;
+      }
+    }
+  }
+}
+
+// What the outline entry points of the other bindings do in one call.
+static uint32_t outline_file(TSParser *parser, const char *path) {
+  uint32_t length;
+  char *source = lean_read_file(path, &length);
+  if (!source)
+    return 0;
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+  LeanOutline items = array_new();
+  lean_outline_collect(ts_tree_root_node(tree), &items);
+  uint32_t count = items.size;
+  array_delete(&items);
+  ts_tree_delete(tree);
+  free(source);
+  return count;
+}
+
+static void report(const char *file, const char *op, uint32_t bytes,
+                   uint32_t count, unsigned iterations, double elapsed) {
+  JsonBuffer line = array_new();
+  json_printf(&line, "{\"binding\": \"c\", \"op\": \"%s\", \"file\": ", op);
+  json_write_string(&line, file, strlen(file));
+  json_printf(&line,
+              ", \"bytes\": %u, \"count\": %u, \"iterations\": %u, "
+              "\"ms\": %.6f}",
+              bytes, count, iterations, elapsed * 1e3 / iterations);
+  printf("%.*s\n", (int)line.size, line.contents);
+  array_delete(&line);
+}
+
+// The name results are matched by across bindings: the path relative to the
+// argument it was found under, or the file name for a file argument.
+static const char *file_name(const char *path, const char *arg) {
+  size_t length = strlen(arg);
+  if (strcmp(path, arg) != 0 && strncmp(path, arg, length) == 0) {
+    path += length;
+    while (*path == '/')
+      path++;
+    return path;
+  }
+  const char *slash = strrchr(path, '/');
+  return slash ? slash + 1 : path;
+}
+
+static int bench_file(TSParser *parser, const char *path, const char *name,
+                      unsigned iterations) {
+  uint32_t length;
+  char *source = lean_read_file(path, &length);
+  if (!source) {
+    perror(path);
+    return 1;
+  }
+
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+  double start = now();
+  for (unsigned i = 0; i < iterations; i++)
+    ts_tree_delete(ts_parser_parse_string(parser, NULL, source, length));
+  report(name, "parse", length,
+         ts_node_descendant_count(ts_tree_root_node(tree)), iterations,
+         now() - start);
+
+  uint32_t count = walk(tree);
+  start = now();
+  for (unsigned i = 0; i < iterations; i++)
+    walk(tree);
+  report(name, "walk", length, count, iterations, now() - start);
+
+  count = outline_file(parser, path);
+  start = now();
+  for (unsigned i = 0; i < iterations; i++)
+    outline_file(parser, path);
+  report(name, "outline", length, count, iterations, now() - start);
+
+  ts_tree_delete(tree);
+  free(source);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  unsigned iterations = 20;
+  int first = 1;
+  for (; first + 1 < argc; first += 2) {
+    if (strcmp(argv[first], "-n") == 0)
+      iterations = (unsigned)strtoul(argv[first + 1], NULL, 10);
+    else
+      break;
+  }
+  if (!iterations)
+    iterations = 1;
+  if (first >= argc) {
+    fprintf(stderr, "usage: %s [-n iterations] path...\n",
+            argv[0]);
+    return 2;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_lean());
+  int status = 0;
+  for (int a = first; a < argc && !status; a++) {
+    LeanPaths paths = array_new();
+    lean_collect_files(argv[a], &paths);
+    for (uint32_t i = 0; i < paths.size && !status; i++)
+      status = bench_file(parser, paths.contents[i],
+                          file_name(paths.contents[i], argv[a]), iterations);
+    lean_paths_delete(&paths);
+  }
+  ts_parser_delete(parser);
+  return status;
+}
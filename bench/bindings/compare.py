@@ -0,0 +1,141 @@
+"""Summarizes the results of the cross-binding benchmark, and compares them
+with an earlier run.
+
+usage: python bench/bindings/compare.py [-b baseline.jsonl] [-t percent] results.jsonl...
+
+Every script of bench/bindings (c.c, node.js, python.py, go/main.go and
+rust.rs) times the same operations on the same corpus, with the same parser,
+and prints one JSON line per file and operation:
+
+    {"binding": "python", "op": "walk", "file": "train/docs.lean",
+     "bytes": 4210, "count": 1523, "iterations": 20, "ms": 1.234}
+
+Through the binding of the tree-sitter library itself:
+
+- parse: parsing the file from scratch, `count` being the number of nodes
+- walk: a pre-order walk of the whole tree with a cursor, reading the type
+  and byte range of every node, `count` being the number of nodes visited
+
+Through this grammar's own entry points, where the binding has them:
+
+- outline: reading, parsing and outlining the file in one call (C
+  lean_outline_collect, Node `outline`, Python `parse_many`, Go `ParseFiles`,
+  Rust `outline`), `count` being the number of entries
+- table: Python's `node_table`, `count` being the number of rows
+- batch: every file at once on all cores (Node `ParsePool`, Python
+  `parse_many`, Go `ParseFiles`, Rust `parse_files`), reported as file `*`
+  with the total size, `count` being the number of outline entries
+
+`ms` is the mean time per iteration. The work is the same in every binding,
+so the ratio to C is the cost the binding layer adds. Counts that differ
+between bindings mean that a script no longer does the same work, and are
+reported as errors.
+
+With `-b`, each binding and operation is also compared with the baseline
+results, and the exit status is 1 if any got slower by more than `-t`
+percent (default 10).
+"""
+
+import json
+import sys
+from collections import defaultdict
+
+OPS = ("parse", "walk", "outline", "table", "batch")
+
+
+def load(paths):
+    results = {}
+    for path in paths:
+        with open(path) as f:
+            for line in f:
+                if line.strip():
+                    r = json.loads(line)
+                    results[r["binding"], r["op"], r["file"]] = r
+    return results
+
+
+def totals(results, binding, op, files):
+    """The total time and size of `op` over `files`, or None if `binding` is
+    missing any of them."""
+    ms = size = 0
+    for file in files:
+        r = results.get((binding, op, file))
+        if r is None:
+            return None
+        ms += r["ms"]
+        size += r["bytes"]
+    return ms, size
+
+
+def check_counts(results):
+    counts = defaultdict(dict)
+    for (binding, op, file), r in results.items():
+        counts[op, file][binding] = r["count"]
+    ok = True
+    for (op, file), by_binding in sorted(counts.items()):
+        if len(set(by_binding.values())) > 1:
+            found = ", ".join(f"{b} {n}" for b, n in sorted(by_binding.items()))
+            print(f"error: {op} {file}: counts differ ({found})", file=sys.stderr)
+            ok = False
+    return ok
+
+
+def summary(results):
+    bindings = sorted({b for b, _, _ in results}, key=lambda b: (b != "c", b))
+    ops = [op for op in OPS if any(o == op for _, o, _ in results)]
+    print(f"{'':10}" + "".join(f"{op:>24}" for op in ops))
+    for binding in bindings:
+        row = f"{binding:10}"
+        for op in ops:
+            files = {f for b, o, f in results if b == binding and o == op}
+            mine = totals(results, binding, op, files)
+            if not mine or not mine[0]:
+                row += f"{'-':>24}"
+                continue
+            cell = f"{mine[0]:.3f} ms"
+            c = totals(results, "c", op, files)
+            if binding != "c" and c and c[0]:
+                cell += f" ({mine[0] / c[0]:.1f}x C)"
+            row += f"{cell:>24}"
+        print(row)
+
+
+def regressions(results, baseline, threshold):
+    slower = False
+    for binding, op in sorted({(b, o) for b, o, _ in results}):
+        files = {f for b, o, f in results if (b, o) == (binding, op)}
+        files &= {f for b, o, f in baseline if (b, o) == (binding, op)}
+        now, before = totals(results, binding, op, files), totals(baseline, binding, op, files)
+        if not files or not before or not before[0]:
+            continue
+        change = (now[0] / before[0] - 1) * 100
+        flag = ""
+        if change > threshold:
+            flag = "  slower"
+            slower = True
+        print(f"{binding} {op}: {before[0]:.3f} -> {now[0]:.3f} ms ({change:+.1f}%){flag}")
+    return not slower
+
+
+def main(args):
+    baseline, threshold = None, 10.0
+    while len(args) > 1 and args[0] in ("-b", "-t"):
+        if args[0] == "-b":
+            baseline = load([args[1]])
+        else:
+            threshold = float(args[1])
+        args = args[2:]
+    if not args:
+        sys.exit(__doc__.split("\n\n")[1])
+
+    results = load(args)
+    ok = check_counts(results)
+    summary(results)
+    if baseline is not None:
+        print()
+        ok = regressions(results, baseline, threshold) and ok
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,183 @@
+// The Go side of the cross-binding benchmark (see compare.py): parsing and
+// walking through go-tree-sitter, with a cgo call or more per node, and
+// outlining through this package's ParseFiles, with one cgo call per batch.
+//
+// usage: go run -tags lean_batch ./bench/bindings/go [-n iterations] [file.lean | dir]...
+//
+// Without the lean_batch tag, ParseFiles isn't available and only parse and
+// walk are timed.
+package main
+
+import (
+	"encoding/json"
+	"errors"
+	"flag"
+	"fmt"
+	"io/fs"
+	"os"
+	"path/filepath"
+	"runtime"
+	"sort"
+	"strings"
+	"time"
+
+	tree_sitter_lean "github.com/estradilua/tree-sitter-lean/bindings/go"
+	tree_sitter "github.com/tree-sitter/go-tree-sitter"
+)
+
+var sink uint
+
+func walk(tree *tree_sitter.Tree) int {
+	cursor := tree.Walk()
+	defer cursor.Close()
+	nodes := 0
+	for {
+		node := cursor.Node()
+		sink += uint(node.KindId()) + node.StartByte() + node.EndByte()
+		nodes++
+		if cursor.GotoFirstChild() {
+			continue
+		}
+		for !cursor.GotoNextSibling() {
+			if !cursor.GotoParent() {
+				return nodes
+			}
+		}
+	}
+}
+
+// outlines returns the number of outline entries of all paths, parsed and
+// outlined on the C side by ParseFiles.
+func outlines(paths []string, workers int) (int, error) {
+	count := 0
+	for _, result := range tree_sitter_lean.ParseFiles(paths, workers) {
+		if result.Err != nil {
+			return 0, result.Err
+		}
+		count += len(result.Outline)
+	}
+	return count, nil
+}
+
+// file is a path to benchmark and the name results are matched by across
+// bindings: the path relative to the directory argument, or the file name.
+type file struct{ path, name string }
+
+func collect(arg string) ([]file, error) {
+	info, err := os.Stat(arg)
+	if err != nil {
+		return nil, err
+	}
+	if !info.IsDir() {
+		return []file{{arg, filepath.Base(arg)}}, nil
+	}
+	var files []file
+	err = filepath.WalkDir(arg, func(path string, entry fs.DirEntry, err error) error {
+		if err != nil || entry.IsDir() || !strings.HasSuffix(path, ".lean") {
+			return err
+		}
+		name, err := filepath.Rel(arg, path)
+		files = append(files, file{path, filepath.ToSlash(name)})
+		return err
+	})
+	sort.Slice(files, func(i, j int) bool { return files[i].path < files[j].path })
+	return files, err
+}
+
+func timed(iterations int, fn func()) float64 {
+	start := time.Now()
+	for range iterations {
+		fn()
+	}
+	return float64(time.Since(start).Nanoseconds()) / 1e6 / float64(iterations)
+}
+
+type result struct {
+	Binding    string  `json:"binding"`
+	Op         string  `json:"op"`
+	File       string  `json:"file"`
+	Bytes      int     `json:"bytes"`
+	Count      int     `json:"count"`
+	Iterations int     `json:"iterations"`
+	Ms         float64 `json:"ms"`
+}
+
+func report(r result) {
+	r.Binding = "go"
+	line, _ := json.Marshal(r)
+	fmt.Println(string(line))
+}
+
+func main() {
+	iterations := flag.Int("n", 20, "iterations per file and operation")
+	flag.Parse()
+	if *iterations < 1 {
+		*iterations = 1
+	}
+	args := flag.Args()
+	if len(args) == 0 {
+		_, self, _, _ := runtime.Caller(0)
+		args = []string{filepath.Join(filepath.Dir(self), "..", "..", "corpus")}
+	}
+
+	parser := tree_sitter.NewParser()
+	defer parser.Close()
+	if err := parser.SetLanguage(tree_sitter.NewLanguage(tree_sitter_lean.Language())); err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(1)
+	}
+
+	var all []file
+	for _, arg := range args {
+		files, err := collect(arg)
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(1)
+		}
+		all = append(all, files...)
+	}
+	if len(all) == 0 {
+		return
+	}
+	native := !errors.Is(tree_sitter_lean.ParseFiles([]string{all[0].path}, 1)[0].Err, tree_sitter_lean.ErrNoBatch)
+	if !native {
+		fmt.Fprintln(os.Stderr, tree_sitter_lean.ErrNoBatch, "- skipping outline and batch")
+	}
+
+	paths, total := make([]string, len(all)), 0
+	for i, f := range all {
+		source, err := os.ReadFile(f.path)
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(1)
+		}
+		n, size := *iterations, len(source)
+		paths[i], total = f.path, total+size
+		tree := parser.Parse(source, nil)
+		report(result{Op: "parse", File: f.name, Bytes: size, Count: int(tree.RootNode().DescendantCount()),
+			Iterations: n, Ms: timed(n, func() { parser.Parse(source, nil).Close() })})
+		report(result{Op: "walk", File: f.name, Bytes: size, Count: walk(tree),
+			Iterations: n, Ms: timed(n, func() { walk(tree) })})
+		tree.Close()
+		if native {
+			one := []string{f.path}
+			count, err := outlines(one, 1)
+			if err != nil {
+				fmt.Fprintln(os.Stderr, err)
+				os.Exit(1)
+			}
+			report(result{Op: "outline", File: f.name, Bytes: size, Count: count,
+				Iterations: n, Ms: timed(n, func() { outlines(one, 1) })})
+		}
+	}
+
+	if native {
+		count, err := outlines(paths, 0)
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(1)
+		}
+		report(result{Op: "batch", File: "*", Bytes: total, Count: count,
+			Iterations: *iterations, Ms: timed(*iterations, func() { outlines(paths, 0) })})
+	}
+}
@@ -0,0 +1,118 @@
+// The Node side of the cross-binding benchmark (see compare.py): parsing and
+// walking through node-tree-sitter, and outlining through the addon's own
+// `outline` and `ParsePool`.
+//
+// usage: node bench/bindings/node.js [-n iterations] [file.lean | dir]...
+//
+// node-tree-sitter parses strings, so the source is decoded once up front and
+// the conversion is not counted. `outline` takes the file's bytes as read.
+
+const fs = require("node:fs");
+const path = require("node:path");
+
+const Parser = require("tree-sitter");
+const Lean = require("../../bindings/node");
+
+let sink = 0;
+
+function walk(tree) {
+  const cursor = tree.walk();
+  let nodes = 0;
+  for (;;) {
+    sink += cursor.nodeTypeId + cursor.startIndex + cursor.endIndex;
+    nodes++;
+    if (cursor.gotoFirstChild()) continue;
+    while (!cursor.gotoNextSibling()) {
+      if (!cursor.gotoParent()) return nodes;
+    }
+  }
+}
+
+// [path, name] pairs, the name being what results are matched by across
+// bindings: the path relative to the directory argument, or the file name.
+function collect(arg, files, dir = arg) {
+  if (fs.statSync(arg).isDirectory()) {
+    for (const name of fs.readdirSync(arg).sort()) {
+      const child = path.join(arg, name);
+      if (fs.statSync(child).isDirectory() || name.endsWith(".lean")) collect(child, files, dir);
+    }
+  } else {
+    files.push([arg, arg === dir ? path.basename(arg) : path.relative(dir, arg)]);
+  }
+  return files;
+}
+
+function time(iterations, fn) {
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < iterations; i++) fn();
+  return Number(process.hrtime.bigint() - start) / 1e6 / iterations;
+}
+
+async function timeAsync(iterations, fn) {
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < iterations; i++) await fn();
+  return Number(process.hrtime.bigint() - start) / 1e6 / iterations;
+}
+
+// The number of outline entries of a file, read and parsed natively.
+function outlineFile(file) {
+  return Lean.outline(fs.readFileSync(file)).kinds.length;
+}
+
+async function outlineFiles(pool, files) {
+  const outlines = await pool.outlineFiles(files);
+  return outlines.reduce((count, outline) => count + outline.kinds.length, 0);
+}
+
+function report(file, op, bytes, count, iterations, ms) {
+  console.log(JSON.stringify({ binding: "node", op, file, bytes, count, iterations, ms }));
+}
+
+async function main(args) {
+  let iterations = 20;
+  if (args[0] === "-n") {
+    iterations = Math.max(1, parseInt(args[1], 10));
+    args = args.slice(2);
+  }
+
+  const parser = new Parser();
+  parser.setLanguage(Lean);
+  const files = [];
+  for (const arg of args.length ? args : [path.join(__dirname, "..", "corpus")]) collect(arg, files);
+
+  // `outline` and ParsePool are only built with the tree-sitter package
+  const native = Boolean(Lean.outline);
+  if (!native) console.error("the addon was built without `outline`, skipping outline and batch");
+
+  for (const [file, name] of files) {
+    const buffer = fs.readFileSync(file);
+    const source = buffer.toString();
+
+    const tree = parser.parse(source);
+    const parseMs = time(iterations, () => parser.parse(source));
+    report(name, "parse", buffer.length, tree.rootNode.descendantCount, iterations, parseMs);
+    const nodes = walk(tree);
+    report(name, "walk", buffer.length, nodes, iterations, time(iterations, () => walk(tree)));
+    if (native) {
+      const items = outlineFile(file);
+      report(name, "outline", buffer.length, items, iterations, time(iterations, () => outlineFile(file)));
+    }
+  }
+
+  if (native && files.length) {
+    const paths = files.map(([file]) => file);
+    const bytes = paths.reduce((size, file) => size + fs.statSync(file).size, 0);
+    const pool = new Lean.ParsePool();
+    try {
+      const items = await outlineFiles(pool, paths);
+      report("*", "batch", bytes, items, iterations, await timeAsync(iterations, () => outlineFiles(pool, paths)));
+    } finally {
+      await pool.close();
+    }
+  }
+}
+
+main(process.argv.slice(2)).catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
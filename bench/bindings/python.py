@@ -0,0 +1,100 @@
+"""The Python side of the cross-binding benchmark (see compare.py): parsing
+and walking through py-tree-sitter, and outlining through this package's own
+`parse_many` and `node_table`.
+
+usage: python bench/bindings/python.py [-n iterations] [file.lean | dir]...
+"""
+
+import json
+import sys
+from pathlib import Path
+from time import perf_counter
+
+import tree_sitter
+import tree_sitter_lean
+
+
+def walk(tree):
+    cursor = tree.walk()
+    nodes = sink = 0
+    while True:
+        node = cursor.node
+        sink += node.kind_id + node.start_byte + node.end_byte
+        nodes += 1
+        if cursor.goto_first_child():
+            continue
+        while not cursor.goto_next_sibling():
+            if not cursor.goto_parent():
+                return nodes
+
+
+def outlines(paths, threads=None):
+    """The number of outline entries of all `paths`."""
+    count = 0
+    for result in tree_sitter_lean.parse_many(paths, threads):
+        if result["error"]:
+            raise OSError(result["error"])
+        count += len(result["outline"])
+    return count
+
+
+def collect(paths):
+    """(path, name) pairs, the name being what results are matched by across
+    bindings: the path relative to the directory argument, or the file name."""
+    for path in map(Path, paths):
+        if path.is_dir():
+            for file in sorted(path.rglob("*.lean")):
+                yield file, file.relative_to(path).as_posix()
+        else:
+            yield path, path.name
+
+
+def timed(iterations, fn):
+    start = perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (perf_counter() - start) / iterations
+
+
+def report(file, op, size, count, iterations, seconds):
+    print(json.dumps({"binding": "python", "op": op, "file": file, "bytes": size,
+                      "count": count, "iterations": iterations, "ms": seconds * 1e3}))
+
+
+def main(args):
+    iterations = 20
+    if args[:1] == ["-n"]:
+        iterations = max(1, int(args[1]))
+        args = args[2:]
+
+    parser = tree_sitter.Parser(tree_sitter.Language(tree_sitter_lean.language()))
+    # parse_many and node_table are only built against the tree-sitter runtime
+    native = hasattr(tree_sitter_lean, "parse_many")
+    if not native:
+        print("tree_sitter_lean was built without parse_many, skipping outline, "
+              "table and batch", file=sys.stderr)
+    default = Path(__file__).resolve().parent.parent / "corpus"
+    files = list(collect(args or [default]))
+    for path, name in files:
+        source = path.read_bytes()
+        tree = parser.parse(source)
+        report(name, "parse", len(source), tree.root_node.descendant_count, iterations,
+               timed(iterations, lambda: parser.parse(source)))
+        report(name, "walk", len(source), walk(tree), iterations,
+               timed(iterations, lambda: walk(tree)))
+        if native:
+            report(name, "outline", len(source), outlines([path], 1), iterations,
+                   timed(iterations, lambda: outlines([path], 1)))
+            rows = len(tree_sitter_lean.node_table(source)["kind"])
+            report(name, "table", len(source), rows, iterations,
+                   timed(iterations, lambda: tree_sitter_lean.node_table(source)))
+
+    if native and files:
+        paths = [path for path, _ in files]
+        size = sum(path.stat().st_size for path in paths)
+        report("*", "batch", size, outlines(paths), iterations,
+               timed(iterations, lambda: outlines(paths)))
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
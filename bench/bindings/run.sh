@@ -0,0 +1,50 @@
+#!/bin/sh
+# Runs the cross-binding benchmark for every binding whose toolchain is
+# installed and summarizes the results with compare.py.
+#
+# usage: bench/bindings/run.sh [-n iterations] [-o output.jsonl] [file.lean | dir]...
+#
+# The C benchmark is built with CMake in build/bindings-bench, the Node and
+# Python ones use the bindings as installed (`npm install`, `pip install -e .`),
+# Go is built with the lean_batch tag so that ParseFiles runs natively.
+# Results go to build/bindings-bench/results.jsonl unless `-o` is given; pass
+# an older file to `compare.py -b` to look for regressions.
+
+set -e
+
+cd "$(dirname "$0")/../.."
+iterations=20
+output=build/bindings-bench/results.jsonl
+while [ $# -gt 1 ]; do
+  case $1 in
+    -n) iterations=$2 ;;
+    -o) output=$2 ;;
+    *) break ;;
+  esac
+  shift 2
+done
+[ $# -gt 0 ] || set -- bench/corpus
+
+mkdir -p build/bindings-bench "$(dirname "$output")"
+: > "$output"
+
+cmake -S . -B build/bindings-bench -DCMAKE_BUILD_TYPE=Release \
+  -DTREE_SITTER_LEAN_TOOLS=ON > /dev/null
+cmake --build build/bindings-bench --target tree-sitter-lean-bindings-bench > /dev/null
+build/bindings-bench/tree-sitter-lean-bindings-bench -n "$iterations" "$@" >> "$output"
+
+run() {
+  if command -v "$1" > /dev/null; then
+    shift
+    "$@" >> "$output" || echo "$*: failed" >&2
+  else
+    echo "$1 not found, skipping" >&2
+  fi
+}
+
+run node node bench/bindings/node.js -n "$iterations" "$@"
+run python3 python3 bench/bindings/python.py -n "$iterations" "$@"
+run go go run -tags lean_batch ./bench/bindings/go -n "$iterations" "$@"
+run cargo cargo bench --quiet --features parallel --bench bindings -- -n "$iterations" "$@"
+
+python3 bench/bindings/compare.py "$output"
@@ -0,0 +1,146 @@
+//! The Rust side of the cross-binding benchmark (see compare.py): parsing and
+//! walking through the `tree-sitter` crate, and outlining through this
+//! crate's `outline` and `parse_files`.
+//!
+//! cargo bench --features parallel --bench bindings -- [-n iterations] [file.lean | dir]...
+
+use std::env;
+use std::fs;
+use std::hint::black_box;
+use std::path::{Path, PathBuf};
+use std::process;
+use std::time::Instant;
+
+use tree_sitter::{Parser, Tree};
+
+fn walk(tree: &Tree) -> usize {
+    let mut cursor = tree.walk();
+    let mut nodes = 0;
+    loop {
+        let node = cursor.node();
+        black_box((node.kind_id(), node.start_byte(), node.end_byte()));
+        nodes += 1;
+        if cursor.goto_first_child() {
+            continue;
+        }
+        while !cursor.goto_next_sibling() {
+            if !cursor.goto_parent() {
+                return nodes;
+            }
+        }
+    }
+}
+
+/// `(path, name)` pairs, the name being what results are matched by across
+/// bindings: the path relative to the directory argument, or the file name.
+fn collect(dir: &Path, path: &Path, files: &mut Vec<(PathBuf, String)>) {
+    if path.is_dir() {
+        let mut entries: Vec<_> = fs::read_dir(path)
+            .unwrap_or_else(|error| fail(path, error))
+            .map(|entry| entry.unwrap().path())
+            .collect();
+        entries.sort();
+        for entry in entries {
+            if entry.is_dir()
+                || entry
+                    .extension()
+                    .is_some_and(|extension| extension == "lean")
+            {
+                collect(dir, &entry, files);
+            }
+        }
+    } else {
+        let name = match path.strip_prefix(dir) {
+            Ok(relative) if path != dir => relative.to_string_lossy().replace('\\', "/"),
+            _ => path.file_name().unwrap().to_string_lossy().into_owned(),
+        };
+        files.push((path.to_owned(), name));
+    }
+}
+
+fn fail(path: &Path, error: impl std::fmt::Display) -> ! {
+    eprintln!("{}: {error}", path.display());
+    process::exit(1)
+}
+
+/// The number of outline entries of `path`, read and parsed anew.
+fn outline_file(parser: &mut Parser, path: &Path) -> usize {
+    let source = fs::read(path).unwrap_or_else(|error| fail(path, error));
+    let tree = parser.parse(&source, None).unwrap();
+    tree_sitter_lean::outline(&tree).len()
+}
+
+/// The number of outline entries of all `paths`, parsed on every core.
+fn outline_files(paths: &[PathBuf]) -> usize {
+    tree_sitter_lean::parse_files(paths.to_vec())
+        .into_iter()
+        .zip(paths)
+        .map(|(file, path)| file.unwrap_or_else(|error| fail(path, error)).outline.len())
+        .sum()
+}
+
+fn timed(iterations: usize, mut f: impl FnMut()) -> f64 {
+    let start = Instant::now();
+    for _ in 0..iterations {
+        f();
+    }
+    start.elapsed().as_secs_f64() * 1e3 / iterations as f64
+}
+
+fn report(file: &str, op: &str, bytes: usize, count: usize, iterations: usize, ms: f64) {
+    let file = file.replace('\\', "\\\\").replace('"', "\\\"");
+    println!(
+        "{{\"binding\": \"rust\", \"op\": \"{op}\", \"file\": \"{file}\", \"bytes\": {bytes}, \
+         \"count\": {count}, \"iterations\": {iterations}, \"ms\": {ms:.6}}}"
+    );
+}
+
+fn main() {
+    // `cargo bench` passes `--bench` to benchmarks without a harness
+    let mut args: Vec<String> = env::args().skip(1).filter(|arg| arg != "--bench").collect();
+    let mut iterations = 20;
+    if args.first().is_some_and(|arg| arg == "-n") && args.len() > 1 {
+        iterations = args[1].parse().unwrap_or(1).max(1);
+        args.drain(..2);
+    }
+    if args.is_empty() {
+        args.push(concat!(env!("CARGO_MANIFEST_DIR"), "/bench/corpus").to_owned());
+    }
+
+    let mut parser = Parser::new();
+    parser
+        .set_language(&tree_sitter_lean::LANGUAGE.into())
+        .expect("Error loading Lean parser");
+    let mut files = Vec::new();
+    for arg in &args {
+        collect(Path::new(arg), Path::new(arg), &mut files);
+    }
+
+    let mut total = 0;
+    for (path, name) in &files {
+        let source = fs::read(path).unwrap_or_else(|error| fail(path, error));
+        total += source.len();
+        let tree = parser.parse(&source, None).unwrap();
+        let ms = timed(iterations, || drop(parser.parse(&source, None)));
+        let nodes = tree.root_node().descendant_count();
+        report(name, "parse", source.len(), nodes, iterations, ms);
+        let ms = timed(iterations, || {
+            black_box(walk(&tree));
+        });
+        report(name, "walk", source.len(), walk(&tree), iterations, ms);
+        let items = outline_file(&mut parser, path);
+        let ms = timed(iterations, || {
+            black_box(outline_file(&mut parser, path));
+        });
+        report(name, "outline", source.len(), items, iterations, ms);
+    }
+
+    if !files.is_empty() {
+        let paths: Vec<_> = files.into_iter().map(|(path, _)| path).collect();
+        let items = outline_files(&paths);
+        let ms = timed(iterations, || {
+            black_box(outline_files(&paths));
+        });
+        report("*", "batch", total, items, iterations, ms);
+    }
+}
@@ -0,0 +1,125 @@
+/-!
+# Leftist heaps
+
+Mergeable priority queues over an ordered type, with the rank invariant and
+proofs that the operations preserve it.
+-/
+
+namespace Leftist
+
+variable {α : Type u} [Ord α]
+
+inductive Heap (α : Type u) where
+  | empty : Heap α
+  | node (rank : Nat) (value : α) (left right : Heap α) : Heap α
+  deriving Repr
+
+namespace Heap
+
+def rank : Heap α → Nat
+  | empty => 0
+  | node r _ _ _ => r
+
+def isEmpty : Heap α → Bool
+  | empty => true
+  | node .. => false
+
+/-- Builds a node, putting the child of larger rank on the left. -/
+def make (x : α) (a b : Heap α) : Heap α :=
+  if a.rank ≥ b.rank then node (b.rank + 1) x a b
+  else node (a.rank + 1) x b a
+
+/-- Merges two heaps along their right spines. -/
+def merge : Heap α → Heap α → Heap α
+  | empty, h => h
+  | h, empty => h
+  | h₁@(node _ x l₁ r₁), h₂@(node _ y l₂ r₂) =>
+    match compare x y with
+    | .gt => make y l₂ (merge h₁ r₂)
+    | _ => make x l₁ (merge r₁ h₂)
+termination_by h₁ h₂ => sizeOf h₁ + sizeOf h₂
+
+def singleton (x : α) : Heap α := node 1 x empty empty
+
+def insert (x : α) (h : Heap α) : Heap α := merge (singleton x) h
+
+def min? : Heap α → Option α
+  | empty => none
+  | node _ x _ _ => some x
+
+def deleteMin : Heap α → Heap α
+  | empty => empty
+  | node _ _ l r => merge l r
+
+def popMin? (h : Heap α) : Option (α × Heap α) :=
+  h.min?.map (·, h.deleteMin)
+
+def size : Heap α → Nat
+  | empty => 0
+  | node _ _ l r => l.size + r.size + 1
+
+def ofList (xs : List α) : Heap α := xs.foldr insert empty
+
+partial def toSortedList (h : Heap α) : List α :=
+  match h.popMin? with
+  | none => []
+  | some (x, h') => x :: toSortedList h'
+
+/-- The rank is the length of the right spine, and never decreases from the
+right child to the left one. -/
+inductive WF : Heap α → Prop
+  | empty : WF empty
+  | node : WF l → WF r → r.rank ≤ l.rank → n = r.rank + 1 → WF (node n x l r)
+
+theorem WF.make {x : α} {a b : Heap α} (ha : WF a) (hb : WF b) : WF (make x a b) := by
+  unfold Heap.make
+  split
+  · next h => exact .node ha hb h rfl
+  · next h => exact .node hb ha (by omega) rfl
+
+theorem WF.merge {h₁ h₂ : Heap α} (w₁ : WF h₁) (w₂ : WF h₂) : WF (merge h₁ h₂) := by
+  induction h₁, h₂ using Heap.merge.induct with
+  | case1 h => simpa [Heap.merge]
+  | case2 h _ => cases h <;> simpa [Heap.merge]
+  | case3 _ x l₁ r₁ _ y l₂ r₂ hgt ih =>
+    cases w₂ with
+    | node wl wr _ _ =>
+      rw [Heap.merge, hgt]
+      exact .make wl (ih w₁ wr)
+  | case4 _ x l₁ r₁ _ y l₂ r₂ hle ih =>
+    cases w₁ with
+    | node wl wr _ _ =>
+      simp only [Heap.merge]
+      split
+      · contradiction
+      · exact .make wl (ih wr w₂)
+
+theorem WF.insert {x : α} {h : Heap α} (w : WF h) : WF (h.insert x) :=
+  .merge (.node .empty .empty (Nat.le_refl 0) rfl) w
+
+theorem WF.deleteMin {h : Heap α} (w : WF h) : WF h.deleteMin := by
+  cases w with
+  | empty => exact .empty
+  | node wl wr _ _ => exact .merge wl wr
+
+theorem size_merge (h₁ h₂ : Heap α) : (merge h₁ h₂).size = h₁.size + h₂.size := by
+  induction h₁, h₂ using Heap.merge.induct <;>
+    simp_all [Heap.merge, Heap.make, Heap.size] <;>
+    split <;> simp [Heap.size] <;> omega
+
+theorem size_insert (x : α) (h : Heap α) : (h.insert x).size = h.size + 1 := by
+  simp [Heap.insert, size_merge, singleton, Heap.size]
+  omega
+
+end Heap
+
+/-- Sorts a list with a heap, in `O(n log n)`. -/
+def heapSort (xs : List α) : List α :=
+  (Heap.ofList xs).toSortedList
+
+#eval heapSort [5, 3, 9, 1, 4, 1, 8]
+#eval heapSort ["pear", "apple", "fig"]
+
+example : heapSort [3, 1, 2] = [1, 2, 3] := by native_decide
+
+end Leftist
@@ -0,0 +1,154 @@
+/-!
+# An interpreter for a small imperative language
+
+Statements over integer variables, a big-step evaluator with fuel, a
+constant folder, and proofs that folding preserves the meaning of
+expressions.
+-/
+
+namespace Imp
+
+abbrev Var := String
+
+inductive BinOp where
+  | add | sub | mul | lt | eq | and | or
+  deriving Repr, DecidableEq
+
+inductive Exp where
+  | lit (n : Int)
+  | var (x : Var)
+  | bin (op : BinOp) (a b : Exp)
+  | not (a : Exp)
+  deriving Repr, Inhabited
+
+inductive Stmt where
+  | skip
+  | assign (x : Var) (e : Exp)
+  | seq (s t : Stmt)
+  | ite (c : Exp) (s t : Stmt)
+  | while (c : Exp) (body : Stmt)
+  | print (e : Exp)
+  deriving Repr, Inhabited
+
+/-- Concrete syntax for statements. -/
+declare_syntax_cat imp
+
+syntax ident " := " term : imp
+syntax "print " term : imp
+syntax imp "; " imp : imp
+syntax "if " term " then " imp " else " imp " fi" : imp
+syntax "while " term " do " imp " od" : imp
+syntax "[imp| " imp "]" : term
+
+macro_rules
+  | `([imp| $x:ident := $e]) => `(Stmt.assign $(Lean.quote x.getId.toString) $e)
+  | `([imp| print $e]) => `(Stmt.print $e)
+  | `([imp| $s; $t]) => `(Stmt.seq [imp| $s] [imp| $t])
+  | `([imp| if $c then $s else $t fi]) => `(Stmt.ite $c [imp| $s] [imp| $t])
+  | `([imp| while $c do $s od]) => `(Stmt.while $c [imp| $s])
+
+instance : OfNat Exp n := ⟨.lit n⟩
+instance : Coe Var Exp := ⟨.var⟩
+instance : Add Exp := ⟨.bin .add⟩
+instance : Sub Exp := ⟨.bin .sub⟩
+instance : Mul Exp := ⟨.bin .mul⟩
+
+abbrev Env := Var → Int
+
+def Env.set (σ : Env) (x : Var) (v : Int) : Env :=
+  fun y => if y = x then v else σ y
+
+def BinOp.apply : BinOp → Int → Int → Int
+  | .add, a, b => a + b
+  | .sub, a, b => a - b
+  | .mul, a, b => a * b
+  | .lt, a, b => if a < b then 1 else 0
+  | .eq, a, b => if a = b then 1 else 0
+  | .and, a, b => if a ≠ 0 ∧ b ≠ 0 then 1 else 0
+  | .or, a, b => if a ≠ 0 ∨ b ≠ 0 then 1 else 0
+
+def Exp.eval (σ : Env) : Exp → Int
+  | lit n => n
+  | var x => σ x
+  | bin op a b => op.apply (a.eval σ) (b.eval σ)
+  | not a => if a.eval σ = 0 then 1 else 0
+
+structure Machine where
+  env : Env := fun _ => 0
+  output : Array Int := #[]
+  steps : Nat := 0
+
+inductive Outcome where
+  | done (m : Machine)
+  | outOfFuel (m : Machine)
+
+/-- Runs `s` for at most `fuel` loop iterations. -/
+def exec (fuel : Nat) (s : Stmt) (m : Machine) : Outcome :=
+  match fuel, s with
+  | _, .skip => .done m
+  | _, .assign x e => .done { m with env := m.env.set x (e.eval m.env), steps := m.steps + 1 }
+  | _, .print e => .done { m with output := m.output.push (e.eval m.env) }
+  | fuel, .seq s t =>
+    match exec fuel s m with
+    | .done m' => exec fuel t m'
+    | stuck => stuck
+  | fuel, .ite c s t =>
+    if c.eval m.env ≠ 0 then exec fuel s m else exec fuel t m
+  | 0, .while .. => .outOfFuel m
+  | fuel + 1, w@(.while c body) =>
+    if c.eval m.env = 0 then .done m
+    else match exec fuel body m with
+      | .done m' => exec fuel w m'
+      | stuck => stuck
+
+/-- Folds constant subexpressions. -/
+def Exp.fold : Exp → Exp
+  | bin op a b =>
+    match a.fold, b.fold with
+    | lit x, lit y => lit (op.apply x y)
+    | a', b' => bin op a' b'
+  | not a =>
+    match a.fold with
+    | lit x => lit (if x = 0 then 1 else 0)
+    | a' => not a'
+  | e => e
+
+theorem Exp.fold_eval (σ : Env) (e : Exp) : e.fold.eval σ = e.eval σ := by
+  induction e with
+  | lit | var => rfl
+  | bin op a b iha ihb =>
+    simp only [fold]
+    split <;> simp_all [eval]
+  | not a ih =>
+    simp only [fold]
+    split <;> simp_all [eval]
+
+def Stmt.fold : Stmt → Stmt
+  | assign x e => assign x e.fold
+  | print e => print e.fold
+  | seq s t => seq s.fold t.fold
+  | ite c s t =>
+    match c.fold with
+    | .lit 0 => t.fold
+    | .lit _ => s.fold
+    | c' => ite c' s.fold t.fold
+  | .while c body => .while c.fold body.fold
+  | skip => skip
+
+def factorial : Stmt := [imp|
+  n := 10;
+  acc := 1;
+  while Exp.bin .lt 0 (Exp.var "n") do
+    acc := Exp.var "acc" * Exp.var "n";
+    n := Exp.var "n" - 1
+  od;
+  print Exp.var "acc"]
+
+def runProgram (s : Stmt) (fuel := 1000) : Except String (Array Int) :=
+  match exec fuel s.fold {} with
+  | .done m => .ok m.output
+  | .outOfFuel m => .error s!"out of fuel after {m.steps} steps"
+
+#eval runProgram factorial
+
+end Imp
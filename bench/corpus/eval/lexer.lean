@@ -0,0 +1,199 @@
+/-!
+# A lexer for a configuration language
+
+Tokens, source positions and a hand-written lexer, with string escapes, raw
+strings, nested comments and error reporting.
+-/
+
+namespace Conf
+
+structure Pos where
+  line : Nat := 1
+  column : Nat := 0
+  deriving Repr, BEq, Inhabited
+
+instance : ToString Pos := ⟨fun p => s!"{p.line}:{p.column}"⟩
+
+inductive Token where
+  | ident (name : String)
+  | int (value : Int)
+  | str (value : String)
+  | punct (c : Char)
+  | arrow
+  | eof
+  deriving Repr, BEq, Inhabited
+
+structure Lexeme where
+  token : Token
+  pos : Pos
+  deriving Repr
+
+structure LexError where
+  pos : Pos
+  message : String
+
+instance : ToString LexError := ⟨fun e => s!"{e.pos}: {e.message}"⟩
+
+structure State where
+  input : String
+  it : String.Iterator := input.iter
+  pos : Pos := {}
+
+abbrev LexM := StateT State (Except LexError)
+
+def peek : LexM (Option Char) := do
+  let s ← get
+  return if s.it.hasNext then some s.it.curr else none
+
+def peek2 : LexM (Option Char) := do
+  let s ← get
+  let it := s.it.next
+  return if it.hasNext then some it.curr else none
+
+def advance : LexM Unit := modify fun s =>
+  let c := s.it.curr
+  { s with
+    it := s.it.next
+    pos := if c == '\n' then { line := s.pos.line + 1 } else { s.pos with column := s.pos.column + 1 } }
+
+def error (message : String) : LexM α := do
+  throw { pos := (← get).pos, message }
+
+partial def skipComment (depth : Nat) : LexM Unit := do
+  match ← peek, ← peek2 with
+  | none, _ => error "unterminated comment"
+  | some '-', some '/' =>
+    advance; advance
+    if depth > 1 then skipComment (depth - 1)
+  | some '/', some '-' =>
+    advance; advance
+    skipComment (depth + 1)
+  | _, _ =>
+    advance
+    skipComment depth
+
+partial def skipTrivia : LexM Unit := do
+  match ← peek, ← peek2 with
+  | some c, _ =>
+    if c.isWhitespace then
+      advance
+      skipTrivia
+    else if c == '-' && (← peek2) == some '-' then
+      while (← peek).any (· != '\n') do advance
+      skipTrivia
+    else if c == '/' && (← peek2) == some '-' then
+      advance; advance
+      skipComment 1
+      skipTrivia
+  | none, _ => pure ()
+
+def escape (c : Char) : LexM Char :=
+  match c with
+  | 'n' => pure '\n'
+  | 't' => pure '\t'
+  | '\\' => pure '\\'
+  | '"' => pure '"'
+  | '\'' => pure '\''
+  | c => error s!"unknown escape '\\{c}'"
+
+partial def string (acc : String) : LexM String := do
+  let some c ← peek | error "unterminated string"
+  advance
+  match c with
+  | '"' => return acc
+  | '\\' =>
+    let some e ← peek | error "unterminated escape"
+    advance
+    string (acc.push (← escape e))
+  | c => string (acc.push c)
+
+/-- `r#"..."#`, with as many `#` on both sides. -/
+partial def rawString : LexM String := do
+  let mut hashes := 0
+  while (← peek) == some '#' do
+    advance
+    hashes := hashes + 1
+  unless (← peek) == some '"' do error "expected '\"' after 'r#'"
+  advance
+  let mut acc := ""
+  repeat
+    let some c ← peek | error "unterminated raw string"
+    advance
+    if c == '"' then
+      let mut n := 0
+      while n < hashes && (← peek) == some '#' do
+        advance
+        n := n + 1
+      if n == hashes then return acc
+      acc := acc.push '"' ++ "".pushn '#' n
+    else
+      acc := acc.push c
+  return acc
+
+partial def number (acc : Int) : LexM Int := do
+  match ← peek with
+  | some c =>
+    if c.isDigit then
+      advance
+      number (10 * acc + (c.toNat - '0'.toNat))
+    else if c == '_' then
+      advance
+      number acc
+    else pure acc
+  | none => pure acc
+
+partial def identifier (acc : String) : LexM String := do
+  match ← peek with
+  | some c =>
+    if c.isAlphanum || c == '_' || c == '.' then
+      advance
+      identifier (acc.push c)
+    else pure acc
+  | none => pure acc
+
+def next : LexM Lexeme := do
+  skipTrivia
+  let pos := (← get).pos
+  let some c ← peek | return ⟨.eof, pos⟩
+  let token ← match c with
+    | '"' => advance; Token.str <$> string ""
+    | 'r' =>
+      if (← peek2) == some '#' || (← peek2) == some '"' then
+        advance; Token.str <$> rawString
+      else Token.ident <$> identifier ""
+    | '-' =>
+      advance
+      if (← peek) == some '>' then advance; pure .arrow
+      else pure (.punct '-')
+    | c =>
+      if c.isDigit then Token.int <$> number 0
+      else if c.isAlpha || c == '_' then Token.ident <$> identifier ""
+      else if "{}[](),:=".contains c then advance; pure (.punct c)
+      else error s!"unexpected character '{c}'"
+  return ⟨token, pos⟩
+
+partial def tokenize (input : String) : Except LexError (Array Lexeme) :=
+  go #[] |>.run' { input }
+where
+  go (acc : Array Lexeme) : LexM (Array Lexeme) := do
+    let l ← next
+    if l.token == .eof then return acc.push l
+    go (acc.push l)
+
+def sample := r#"
+server {
+  host = "example.com"  -- the public name
+  port = 8_080
+  /- ports /- nested -/ below 1024 need root -/
+  motd = r##"Say "hi" with #hashtags"##
+  routes = [ "/" -> index, "/api" -> api ]
+}
+"#
+
+#eval match tokenize sample with
+  | .ok ls => s!"{ls.size} tokens"
+  | .error e => toString e
+
+example : (tokenize "a = 1").toOption.map (·.size) = some 4 := by native_decide
+
+end Conf
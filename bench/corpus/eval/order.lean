@@ -0,0 +1,141 @@
+/-!
+# Partial orders and lattices
+
+A from-scratch hierarchy of preorders, partial orders and lattices, with the
+usual notation and a collection of tactic proofs about them.
+-/
+
+namespace Order
+
+universe u
+
+class Preorder' (α : Type u) extends LE α, LT α where
+  le_refl : ∀ a : α, a ≤ a
+  le_trans : ∀ {a b c : α}, a ≤ b → b ≤ c → a ≤ c
+  lt := fun a b => a ≤ b ∧ ¬b ≤ a
+  lt_iff_le_not_le : ∀ {a b : α}, a < b ↔ a ≤ b ∧ ¬b ≤ a := by intros; rfl
+
+class PartialOrder' (α : Type u) extends Preorder' α where
+  le_antisymm : ∀ {a b : α}, a ≤ b → b ≤ a → a = b
+
+class Lattice' (α : Type u) extends PartialOrder' α where
+  sup : α → α → α
+  inf : α → α → α
+  le_sup_left : ∀ a b : α, a ≤ sup a b
+  le_sup_right : ∀ a b : α, b ≤ sup a b
+  sup_le : ∀ {a b c : α}, a ≤ c → b ≤ c → sup a b ≤ c
+  inf_le_left : ∀ a b : α, inf a b ≤ a
+  inf_le_right : ∀ a b : α, inf a b ≤ b
+  le_inf : ∀ {a b c : α}, a ≤ b → a ≤ c → a ≤ inf b c
+
+infixl:68 " ⊔ " => Lattice'.sup
+infixl:69 " ⊓ " => Lattice'.inf
+
+/-- `a ⋖ b`: `b` covers `a`. -/
+def Covers {α : Type u} [Preorder' α] (a b : α) : Prop :=
+  a < b ∧ ∀ c, a < c → ¬c < b
+
+infix:50 " ⋖ " => Covers
+
+notation:50 a " ≤[" α "] " b => @LE.le α _ a b
+
+section Preorder
+
+variable {α : Type u} [Preorder' α] {a b c d : α}
+
+open Preorder'
+
+theorem le_of_lt (h : a < b) : a ≤ b :=
+  (lt_iff_le_not_le.mp h).1
+
+theorem lt_irrefl (a : α) : ¬a < a := fun h =>
+  (lt_iff_le_not_le.mp h).2 (le_refl a)
+
+theorem lt_of_lt_of_le (h₁ : a < b) (h₂ : b ≤ c) : a < c := by
+  rw [lt_iff_le_not_le] at *
+  obtain ⟨hab, hba⟩ := h₁
+  refine ⟨le_trans hab h₂, fun hca => ?_⟩
+  exact hba (le_trans h₂ hca)
+
+theorem lt_of_le_of_lt (h₁ : a ≤ b) (h₂ : b < c) : a < c := by
+  rw [lt_iff_le_not_le] at *
+  rcases h₂ with ⟨hbc, hcb⟩
+  constructor
+  · exact le_trans h₁ hbc
+  · intro hca
+    exact hcb (le_trans hca h₁)
+
+theorem lt_trans (h₁ : a < b) (h₂ : b < c) : a < c :=
+  lt_of_lt_of_le h₁ (le_of_lt h₂)
+
+theorem le_chain (h₁ : a ≤ b) (h₂ : b ≤ c) (h₃ : c ≤ d) : a ≤ d :=
+  calc a ≤ b := h₁
+    _ ≤ c := h₂
+    _ ≤ d := h₃
+
+end Preorder
+
+section Lattice
+
+variable {α : Type u} [Lattice' α] {a b c : α}
+
+open Preorder' PartialOrder' Lattice'
+
+theorem sup_comm (a b : α) : a ⊔ b = b ⊔ a := by
+  apply le_antisymm <;> apply sup_le
+  all_goals first
+    | apply le_sup_left
+    | apply le_sup_right
+
+theorem inf_comm (a b : α) : a ⊓ b = b ⊓ a :=
+  le_antisymm (le_inf (inf_le_right a b) (inf_le_left a b))
+    (le_inf (inf_le_right b a) (inf_le_left b a))
+
+theorem sup_idem (a : α) : a ⊔ a = a :=
+  le_antisymm (sup_le (le_refl a) (le_refl a)) (le_sup_left a a)
+
+theorem sup_assoc (a b c : α) : a ⊔ b ⊔ c = a ⊔ (b ⊔ c) := by
+  apply le_antisymm
+  · apply sup_le
+    · apply sup_le (le_sup_left _ _)
+      exact le_trans (le_sup_left b c) (le_sup_right _ _)
+    · exact le_trans (le_sup_right b c) (le_sup_right _ _)
+  · apply sup_le
+    · exact le_trans (le_sup_left a b) (le_sup_left _ _)
+    · apply sup_le
+      · exact le_trans (le_sup_right a b) (le_sup_left _ _)
+      · exact le_sup_right _ _
+
+theorem sup_eq_right : a ⊔ b = b ↔ a ≤ b := by
+  constructor
+  · intro h
+    rw [← h]
+    exact le_sup_left a b
+  · intro h
+    exact le_antisymm (sup_le h (le_refl b)) (le_sup_right a b)
+
+theorem absorb (a b : α) : a ⊔ (a ⊓ b) = a := by
+  rw [sup_comm, sup_eq_right.mpr (inf_le_left a b)]
+  exact le_antisymm (sup_le (inf_le_left a b) (le_refl a)) (le_sup_right _ _)
+
+end Lattice
+
+instance : Lattice' Nat where
+  le_refl := Nat.le_refl
+  le_trans := Nat.le_trans
+  lt_iff_le_not_le := Nat.lt_iff_le_not_le
+  le_antisymm := Nat.le_antisymm
+  sup := max
+  inf := min
+  le_sup_left := Nat.le_max_left
+  le_sup_right := Nat.le_max_right
+  sup_le := Nat.max_le.mpr ∘ And.intro
+  inf_le_left := Nat.min_le_left
+  inf_le_right := Nat.min_le_right
+  le_inf := fun h₁ h₂ => Nat.le_min.mpr ⟨h₁, h₂⟩
+
+example : (3 : Nat) ⊔ 5 ⊓ 4 = 4 := by decide
+
+example (n : Nat) : n ≤[Nat] n ⊔ 7 := Lattice'.le_sup_left n 7
+
+end Order
@@ -0,0 +1,146 @@
+/-!
+# Build configuration
+
+Records describing packages and their targets, with defaults, inheritance,
+validation and a pretty printer, in the style of a build tool's config.
+-/
+
+namespace Build
+
+inductive Backend where
+  | c | llvm | wasm
+  deriving Repr, BEq, DecidableEq, Inhabited
+
+inductive OptLevel where
+  | o0 | o1 | o2 | o3
+  deriving Repr, BEq, Ord
+
+instance : ToString OptLevel where
+  toString
+    | .o0 => "-O0"
+    | .o1 => "-O1"
+    | .o2 => "-O2"
+    | .o3 => "-O3"
+
+/-- Flags shared by every target. -/
+structure CommonConfig where
+  name : String
+  /-- Extra flags passed to the compiler. -/
+  moreFlags : Array String := #[]
+  optLevel : OptLevel := .o2
+  debug : Bool := false
+  deriving Repr
+
+structure LibConfig extends CommonConfig where
+  roots : Array String := #[name]
+  precompile : Bool := false
+  defaultFacets : List String := ["leanArts"]
+  deriving Repr
+
+structure ExeConfig extends CommonConfig where
+  root : String := "Main"
+  supportInterpreter : Bool := false
+  backend : Backend := .c
+  deriving Repr
+
+structure Dependency where
+  name : String
+  url : String
+  rev : Option String := none
+  subDir : Option String := none
+  deriving Repr, BEq
+
+structure Package where
+  name : String
+  version : Nat × Nat × Nat := (0, 1, 0)
+  libs : Array LibConfig := #[]
+  exes : Array ExeConfig := #[]
+  deps : List Dependency := []
+  testDriver : Option String := none
+  deriving Repr
+
+namespace Package
+
+def versionString (p : Package) : String :=
+  let (major, minor, patch) := p.version
+  s!"{major}.{minor}.{patch}"
+
+def targetNames (p : Package) : List String :=
+  (p.libs.map (·.name)).toList ++ (p.exes.map (·.name)).toList
+
+def findLib? (p : Package) (name : String) : Option LibConfig :=
+  p.libs.find? (·.name == name)
+
+def findExe? (p : Package) (name : String) : Option ExeConfig :=
+  p.exes.find? (·.name == name)
+
+inductive Problem where
+  | duplicateTarget (name : String)
+  | emptyRoots (lib : String)
+  | unknownTestDriver (name : String)
+  | unpinned (dep : String)
+  deriving Repr
+
+def Problem.message : Problem → String
+  | .duplicateTarget n => s!"target '{n}' is defined twice"
+  | .emptyRoots l => s!"library '{l}' has no roots"
+  | .unknownTestDriver n => s!"test driver '{n}' is not a target"
+  | .unpinned d => s!"dependency '{d}' has no revision"
+
+def validate (p : Package) : List Problem := Id.run do
+  let mut problems := []
+  let mut seen : List String := []
+  for name in p.targetNames do
+    if seen.contains name then
+      problems := .duplicateTarget name :: problems
+    seen := name :: seen
+  for lib in p.libs do
+    if lib.roots.isEmpty then
+      problems := .emptyRoots lib.name :: problems
+  if let some driver := p.testDriver then
+    unless seen.contains driver do
+      problems := .unknownTestDriver driver :: problems
+  for dep in p.deps do
+    if dep.rev.isNone then
+      problems := .unpinned dep.name :: problems
+  return problems.reverse
+
+/-- The compiler flags of a target, most specific last. -/
+def flags (c : CommonConfig) : Array String :=
+  #[toString c.optLevel] ++ (if c.debug then #["-g"] else #[]) ++ c.moreFlags
+
+def withDebug (p : Package) : Package :=
+  { p with
+    libs := p.libs.map fun l => { l with debug := true, optLevel := .o0 }
+    exes := p.exes.map fun e => { e with debug := true, optLevel := .o0 } }
+
+def render (p : Package) : String := Id.run do
+  let mut out := s!"package {p.name} v{p.versionString}\n"
+  for lib in p.libs do
+    out := out ++ s!"  lib {lib.name}: roots {lib.roots}, flags {flags lib.toCommonConfig}\n"
+  for exe in p.exes do
+    out := out ++ s!"  exe {exe.name}: root {exe.root}, flags {flags exe.toCommonConfig}\n"
+  for dep in p.deps do
+    let rev := dep.rev.getD "HEAD"
+    out := out ++ s!"  require {dep.name} from {dep.url} @ {rev}\n"
+  return out
+
+end Package
+
+def example₁ : Package where
+  name := "tree-sitter-demo"
+  version := (1, 2, 3)
+  libs := #[{ name := "Demo", precompile := true },
+            { name := "DemoTest", roots := #["DemoTest.Basic", "DemoTest.Parser"] }]
+  exes := #[{ name := "demo", root := "Demo.Main", optLevel := .o3 }]
+  deps := [{ name := "std", url := "https://example.com/std", rev := some "v4.9.0" },
+           { name := "aesop", url := "https://example.com/aesop" }]
+  testDriver := some "DemoTest"
+
+theorem example₁_targets :
+    example₁.targetNames = ["Demo", "DemoTest", "demo"] := rfl
+
+#eval example₁.validate.map Package.Problem.message
+#eval IO.println example₁.withDebug.render
+
+end Build
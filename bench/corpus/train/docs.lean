@@ -0,0 +1,90 @@
+/-!
+# Lists, documented
+
+This module is mostly documentation: it mimics the shape of a Mathlib file
+where every declaration carries a docstring, and the module itself opens with
+a long `/-! ... -/` header describing the contents.
+
+## Main definitions
+
+* `List.sum'`: the sum of a list, defined by structural recursion.
+* `List.prod'`: the product of a list.
+* `List.count'`: the number of occurrences of an element.
+
+## Implementation notes
+
+Docstrings are Markdown. They contain inline code such as `x :: xs`, lists,
+headers, and fenced code blocks:
+
+```lean
+example : [1, 2, 3].sum' = 6 := rfl
+```
+
+Dashes show up a lot in prose -- em-dashes, `a - b`, and horizontal rules:
+
+---
+
+/- Nested comments /- are /- allowed -/ -/ here too. -/
+-/
+
+namespace List
+
+/--
+The sum of a list of natural numbers.
+
+It is defined by structural recursion on the list, so that `simp` can unfold
+it one step at a time:
+
+```lean
+example : sum' [] = 0 := rfl
+example (x : Nat) (xs : List Nat) : sum' (x :: xs) = x + sum' xs := rfl
+```
+
+See also `List.prod'` -- the multiplicative analogue -- and `List.foldl`.
+-/
+def sum' (xs : List Nat) : Nat := xs.foldl (· + ·) 0
+
+/--
+The product of a list of natural numbers.
+
+- the empty product is `1`;
+- the product of `x :: xs` is `x * prod' xs`.
+-/
+def prod' (xs : List Nat) : Nat := xs.foldl (· * ·) 1
+
+/--
+`count' a xs` is the number of times `a` occurs in `xs`.
+
+Note that this counts with respect to `BEq`, not propositional equality --
+for lawful instances the two agree.
+-/
+def count' [BEq α] (a : α) (xs : List α) : Nat := (xs.filter (· == a)).length
+
+/-- The sum of the empty list is zero. -/
+theorem sum'_nil : sum' [] = 0 := rfl
+
+/-- The product of the empty list is one. -/
+theorem prod'_nil : prod' [] = 1 := rfl
+
+/--
+Counting in the empty list always gives zero.
+
+This is a `simp` lemma: it fires whenever `count'` meets `[]`.
+-/
+theorem count'_nil [BEq α] (a : α) : count' a [] = 0 := rfl
+
+/-
+An ordinary block comment. It is not a docstring, so it is neither
+highlighted as Markdown nor attached to the next declaration.
+-/
+
+/--
+A list is *short* when it has at most `n` elements.
+
+---
+
+The definition is intentionally naive; prefer `List.length_le` in proofs.
+-/
+abbrev Short (n : Nat) (xs : List α) : Prop := xs.length ≤ n
+
+end List
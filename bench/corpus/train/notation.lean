@@ -0,0 +1,133 @@
+/-!
+# Notation for a small algebra hierarchy
+
+Typeclasses for monoids and groups, their notation, macros to derive simple
+instances, and a few lemmas proved with the new syntax.
+-/
+
+set_option autoImplicit false
+
+universe u v
+
+/-- A type with an associative operation and a neutral element. -/
+class Monoid' (α : Type u) extends Mul α, One α where
+  mul_assoc : ∀ a b c : α, a * b * c = a * (b * c)
+  one_mul : ∀ a : α, 1 * a = a
+  mul_one : ∀ a : α, a * 1 = a
+
+class Group' (α : Type u) extends Monoid' α, Inv α where
+  inv_mul_cancel : ∀ a : α, a⁻¹ * a = 1
+
+section Notation
+
+variable {α : Type u}
+
+/-- `a ^+ n` is `a` multiplied with itself `n` times. -/
+def npow [Monoid' α] (a : α) : Nat → α
+  | 0 => 1
+  | n + 1 => npow a n * a
+
+infixr:75 " ^+ " => npow
+
+/-- Conjugation. -/
+notation:70 a " ⋆ " b => b * a * b⁻¹
+
+/-- The commutator of two elements. -/
+notation "⁅" a ", " b "⁆" => a * b * a⁻¹ * b⁻¹
+
+prefix:max "√" => Nat.sqrt
+
+postfix:max "†" => Inv.inv
+
+scoped notation "𝟙" => (1 : _)
+
+syntax "∏ " ident " ∈ " term ", " term : term
+
+macro_rules
+  | `(∏ $x ∈ $xs, $body) => `(List.foldl (fun acc $x => acc * $body) 1 $xs)
+
+syntax (name := monoidOf) "monoid_of% " term : term
+
+macro_rules
+  | `(monoid_of% $t) => `(Monoid' $t)
+
+/-- `simp_monoid` normalizes products with the monoid laws. -/
+macro "simp_monoid" : tactic =>
+  `(tactic| simp only [Monoid'.mul_assoc, Monoid'.one_mul, Monoid'.mul_one])
+
+syntax "repeat_mul " num : tactic
+
+macro_rules
+  | `(tactic| repeat_mul 0) => `(tactic| skip)
+  | `(tactic| repeat_mul $n) => `(tactic| (rw [Monoid'.mul_assoc]; repeat_mul $(Lean.quote (n.getNat - 1))))
+
+end Notation
+
+namespace Monoid'
+
+variable {α : Type u} [Monoid' α]
+
+@[simp] theorem npow_zero (a : α) : a ^+ 0 = 1 := rfl
+
+@[simp] theorem npow_succ (a : α) (n : Nat) : a ^+ (n + 1) = a ^+ n * a := rfl
+
+theorem npow_one (a : α) : a ^+ 1 = a := by
+  simp [one_mul]
+
+theorem npow_add (a : α) (m n : Nat) : a ^+ (m + n) = a ^+ m * a ^+ n := by
+  induction n with
+  | zero => simp [mul_one]
+  | succ n ih =>
+    rw [← Nat.add_assoc, npow_succ, ih, npow_succ, mul_assoc]
+
+theorem npow_mul_comm (a : α) (n : Nat) : a ^+ n * a = a * a ^+ n := by
+  induction n with
+  | zero => simp [one_mul, mul_one]
+  | succ n ih => rw [npow_succ, mul_assoc, ih, ← mul_assoc]
+
+end Monoid'
+
+namespace Group'
+
+variable {α : Type u} [Group' α]
+
+open Monoid' in
+theorem mul_left_cancel {a b c : α} (h : a * b = a * c) : b = c := by
+  calc b = 1 * b := (one_mul b).symm
+    _ = a⁻¹ * a * b := by rw [inv_mul_cancel]
+    _ = a⁻¹ * (a * b) := mul_assoc _ _ _
+    _ = a⁻¹ * (a * c) := by rw [h]
+    _ = a⁻¹ * a * c := (mul_assoc _ _ _).symm
+    _ = c := by rw [inv_mul_cancel, one_mul]
+
+theorem mul_inv_cancel (a : α) : a * a⁻¹ = 1 := by
+  have h : a⁻¹ * (a * a⁻¹) = a⁻¹ * 1 := by
+    rw [← Monoid'.mul_assoc, inv_mul_cancel, Monoid'.one_mul, Monoid'.mul_one]
+  exact mul_left_cancel h
+
+theorem conj_one (a : α) : (1 : α) ⋆ a = 1 := by
+  simp [Monoid'.mul_one, mul_inv_cancel]
+
+theorem commutator_self (a : α) : ⁅a, a⁆ = 1 := by
+  rw [Monoid'.mul_assoc a a, mul_inv_cancel, Monoid'.mul_one, mul_inv_cancel]
+
+end Group'
+
+instance : Monoid' Nat where
+  mul_assoc := Nat.mul_assoc
+  one_mul := Nat.one_mul
+  mul_one := Nat.mul_one
+
+instance : Monoid' (List Nat) where
+  mul a b := a ++ b
+  one := []
+  mul_assoc := List.append_assoc
+  one_mul := List.nil_append
+  mul_one := List.append_nil
+
+example : (2 : Nat) ^+ 10 = 1024 := by decide
+
+example : ∏ x ∈ [1, 2, 3, 4], x + 1 = 120 := rfl
+
+#check (monoid_of% Nat)
+#eval √ 17
@@ -0,0 +1,176 @@
+/-!
+# A small parser combinator library
+
+Parsers over `String.Iterator` in a state and exception monad, and a parser
+for arithmetic expressions built with them.
+-/
+
+namespace Comb
+
+structure Error where
+  pos : String.Pos
+  expected : List String
+  deriving Repr, BEq
+
+instance : ToString Error where
+  toString e := s!"at {e.pos.byteIdx}: expected {", ".intercalate e.expected}"
+
+/-- A parser: a function of the input position that can fail. -/
+abbrev Parser := StateT String.Iterator (Except Error)
+
+variable {α β : Type}
+
+def fail (expected : String) : Parser α := do
+  let it ← get
+  throw { pos := it.pos, expected := [expected] }
+
+def peek? : Parser (Option Char) := do
+  let it ← get
+  return if it.hasNext then some it.curr else none
+
+def any : Parser Char := do
+  let it ← get
+  if it.hasNext then
+    set it.next
+    return it.curr
+  else
+    fail "a character"
+
+def satisfy (p : Char → Bool) (what : String) : Parser Char := do
+  let some c ← peek? | fail what
+  if p c then
+    modify (·.next)
+    return c
+  else
+    fail what
+
+def char (c : Char) : Parser Unit :=
+  discard <| satisfy (· == c) s!"'{c}'"
+
+/-- Tries `p`, then `q` from the same position if `p` failed. Errors at the
+same position are merged. -/
+def orElse (p : Parser α) (q : Unit → Parser α) : Parser α := fun it =>
+  match p it with
+  | .ok r => .ok r
+  | .error e₁ =>
+    match q () it with
+    | .ok r => .ok r
+    | .error e₂ =>
+      if e₁.pos == e₂.pos then .error { e₁ with expected := e₁.expected ++ e₂.expected }
+      else if e₁.pos.byteIdx < e₂.pos.byteIdx then .error e₂
+      else .error e₁
+
+instance : OrElse (Parser α) := ⟨orElse⟩
+
+partial def many (p : Parser α) : Parser (Array α) :=
+  go #[]
+where
+  go (acc : Array α) : Parser (Array α) := fun it =>
+    match p it with
+    | .ok (a, it') => if it'.pos == it.pos then .ok (acc, it) else go (acc.push a) it'
+    | .error _ => .ok (acc, it)
+
+def many1 (p : Parser α) : Parser (Array α) := do
+  let first ← p
+  let rest ← many p
+  return #[first] ++ rest
+
+def ws : Parser Unit :=
+  discard <| many (satisfy Char.isWhitespace "whitespace")
+
+def token (p : Parser α) : Parser α := do
+  let a ← p
+  ws
+  return a
+
+def symbol (s : String) : Parser Unit :=
+  token <| s.foldl (fun p c => p *> char c) (pure ())
+
+def nat : Parser Nat := token do
+  let digits ← many1 (satisfy Char.isDigit "a digit")
+  return digits.foldl (fun n d => 10 * n + (d.toNat - '0'.toNat)) 0
+
+def ident : Parser String := token do
+  let first ← satisfy Char.isAlpha "an identifier"
+  let rest ← many (satisfy (fun c => c.isAlphanum || c == '_') "")
+  return String.mk (first :: rest.toList)
+
+def sepBy (p : Parser α) (sep : Parser Unit) : Parser (List α) :=
+  (do
+    let x ← p
+    let xs ← many (sep *> p)
+    return x :: xs.toList)
+  <|> pure []
+
+def between (l r : String) (p : Parser α) : Parser α :=
+  symbol l *> p <* symbol r
+
+/-- Left-associative chains such as `a - b - c`. -/
+def chainl1 (p : Parser α) (op : Parser (α → α → α)) : Parser α := do
+  let mut acc ← p
+  for _ in [0:1000] do
+    match ← (some <$> op) <|> pure none with
+    | some f => acc := f acc (← p)
+    | none => break
+  return acc
+
+def run (p : Parser α) (input : String) : Except Error α :=
+  match (ws *> p) input.iter with
+  | .ok (a, it) =>
+    if it.hasNext then .error { pos := it.pos, expected := ["end of input"] }
+    else .ok a
+  | .error e => .error e
+
+end Comb
+
+namespace Arith
+
+open Comb
+
+inductive Expr where
+  | num : Nat → Expr
+  | var : String → Expr
+  | add | sub | mul | div : Expr → Expr → Expr
+  | call : String → List Expr → Expr
+  deriving Repr, Inhabited
+
+mutual
+  partial def expr : Parser Expr :=
+    chainl1 term ((symbol "+" *> pure .add) <|> (symbol "-" *> pure .sub))
+
+  partial def term : Parser Expr :=
+    chainl1 factor ((symbol "*" *> pure .mul) <|> (symbol "/" *> pure .div))
+
+  partial def factor : Parser Expr :=
+    (.num <$> nat)
+    <|> (do
+      let name ← ident
+      match ← (some <$> between "(" ")" (sepBy expr (symbol ","))) <|> pure none with
+      | some args => return .call name args
+      | none => return .var name)
+    <|> between "(" ")" expr
+end
+
+def eval (env : String → Option Int) : Expr → Except String Int
+  | .num n => pure n
+  | .var x => match env x with
+    | some v => pure v
+    | none => throw s!"unbound variable {x}"
+  | .add a b => return (← eval env a) + (← eval env b)
+  | .sub a b => return (← eval env a) - (← eval env b)
+  | .mul a b => return (← eval env a) * (← eval env b)
+  | .div a b => do
+    let d ← eval env b
+    if d == 0 then throw "division by zero"
+    return (← eval env a) / d
+  | .call f args => do
+    let vs ← args.mapM (eval env)
+    match f, vs with
+    | "max", [a, b] => pure (max a b)
+    | "min", [a, b] => pure (min a b)
+    | "abs", [a] => pure a.natAbs
+    | _, _ => throw s!"unknown function {f}/{vs.length}"
+
+#eval run expr "1 + 2 * (3 - x) / max(4, y)"
+
+end Arith
@@ -0,0 +1,153 @@
+/-!
+# Binary search trees
+
+Unbalanced binary search trees over `Nat` keys, with insertion, lookup,
+folds, and the proofs that insertion keeps the tree ordered.
+-/
+
+namespace BST
+
+/-- A binary tree with a key and a value at every node. -/
+inductive Tree (α : Type u) where
+  | leaf : Tree α
+  | node (left : Tree α) (key : Nat) (value : α) (right : Tree α) : Tree α
+  deriving Repr, Inhabited
+
+variable {α : Type u} {β : Type v}
+
+namespace Tree
+
+/-- The number of nodes of a tree. -/
+def size : Tree α → Nat
+  | leaf => 0
+  | node l _ _ r => l.size + 1 + r.size
+
+/-- The length of the longest path from the root to a leaf. -/
+def height : Tree α → Nat
+  | leaf => 0
+  | node l _ _ r => max l.height r.height + 1
+
+def contains (t : Tree α) (k : Nat) : Bool :=
+  match t with
+  | leaf => false
+  | node l key _ r =>
+    if k < key then l.contains k
+    else if key < k then r.contains k
+    else true
+
+def find? (t : Tree α) (k : Nat) : Option α :=
+  match t with
+  | leaf => none
+  | node l key v r =>
+    if k < key then l.find? k
+    else if key < k then r.find? k
+    else some v
+
+/-- Inserts `k` with `v`, replacing the value of an existing `k`. -/
+def insert (t : Tree α) (k : Nat) (v : α) : Tree α :=
+  match t with
+  | leaf => node leaf k v leaf
+  | node l key w r =>
+    if k < key then node (l.insert k v) key w r
+    else if key < k then node l key w (r.insert k v)
+    else node l k v r
+
+def fold (f : β → Nat → α → β) (init : β) : Tree α → β
+  | leaf => init
+  | node l k v r => r.fold f (f (l.fold f init) k v)
+
+def toList (t : Tree α) : List (Nat × α) :=
+  t.fold (fun acc k v => acc ++ [(k, v)]) []
+
+def keys (t : Tree α) : List Nat :=
+  t.toList.map Prod.fst
+
+def ofList (xs : List (Nat × α)) : Tree α :=
+  xs.foldl (fun t (k, v) => t.insert k v) leaf
+
+def map (f : α → β) : Tree α → Tree β
+  | leaf => leaf
+  | node l k v r => node (l.map f) k (f v) (r.map f)
+
+def min? : Tree α → Option (Nat × α)
+  | leaf => none
+  | node leaf k v _ => some (k, v)
+  | node l _ _ _ => l.min?
+
+/-- Every key of `t` satisfies `p`. -/
+def ForallKeys (p : Nat → Prop) : Tree α → Prop
+  | leaf => True
+  | node l k _ r => ForallKeys p l ∧ p k ∧ ForallKeys p r
+
+/-- The keys are ordered: smaller to the left, larger to the right. -/
+inductive Ordered : Tree α → Prop
+  | leaf : Ordered leaf
+  | node :
+      ForallKeys (· < k) l →
+      ForallKeys (k < ·) r →
+      Ordered l → Ordered r →
+      Ordered (node l k v r)
+
+theorem size_map (f : α → β) (t : Tree α) : (t.map f).size = t.size := by
+  induction t
+  · rfl
+  · simp [map, size, *]
+
+theorem height_le_size (t : Tree α) : t.height ≤ t.size := by
+  induction t with
+  | leaf => simp [height, size]
+  | node l k v r ihl ihr =>
+    simp only [height, size]
+    omega
+
+theorem forallKeys_insert {p : Nat → Prop} {t : Tree α} {k : Nat} {v : α}
+    (ht : ForallKeys p t) (hk : p k) : ForallKeys p (t.insert k v) := by
+  induction t with
+  | leaf => exact ⟨trivial, hk, trivial⟩
+  | node l key w r ihl ihr =>
+    obtain ⟨hl, hkey, hr⟩ := ht
+    simp only [insert]
+    split
+    · exact ⟨ihl hl, hkey, hr⟩
+    · split
+      · exact ⟨hl, hkey, ihr hr⟩
+      · exact ⟨hl, hk, hr⟩
+
+theorem forallKeys_mono {p q : Nat → Prop} (h : ∀ k, p k → q k) :
+    ∀ {t : Tree α}, ForallKeys p t → ForallKeys q t
+  | leaf, _ => trivial
+  | node _ _ _ _, ⟨hl, hk, hr⟩ => ⟨forallKeys_mono h hl, h _ hk, forallKeys_mono h hr⟩
+
+theorem Ordered.insert {t : Tree α} (h : Ordered t) (k : Nat) (v : α) :
+    Ordered (t.insert k v) := by
+  induction h with
+  | leaf => exact .node trivial trivial .leaf .leaf
+  | @node l key r w hl hr ol or ihl ihr =>
+    simp only [Tree.insert]
+    split
+    · next hlt => exact .node (forallKeys_insert hl hlt) hr ihl or
+    · split
+      · next _ hgt => exact .node hl (forallKeys_insert hr hgt) ol ihr
+      · next hnlt hngt =>
+        have : k = key := by omega
+        subst this
+        exact .node hl hr ol or
+
+theorem find?_insert_self (t : Tree α) (k : Nat) (v : α) :
+    (t.insert k v).find? k = some v := by
+  induction t with
+  | leaf => simp [insert, find?]
+  | node l key w r ihl ihr =>
+    unfold insert
+    split <;> simp_all [find?]
+    split <;> simp_all [find?]
+    omega
+
+example : (ofList [(3, "c"), (1, "a"), (2, "b")]).keys = [1, 2, 3] := by
+  decide
+
+#eval (ofList [(5, 'e'), (3, 'c'), (8, 'h'), (1, 'a')]).toList
+
+end Tree
+
+end BST
@@ -0,0 +1,129 @@
+// Compares the native `outline` with the same outline computed by walking the
+// tree from JS through node-tree-sitter, which creates a JS object per node.
+//
+// usage: node bench/node/outline.js [-n iterations] [file.lean | dir]...
+//
+// Both sides parse the file on every iteration, as an indexer would.
+
+const fs = require("node:fs");
+const path = require("node:path");
+
+const Parser = require("tree-sitter");
+const Lean = require("../../bindings/node");
+
+const OUTLINE_COMMANDS = new Set([
+  "cmd_namespace", "cmd_section", "cmd_noncomputable_section",
+  "cmd_initialize", "cmd_mutual", "cmd_mixfix",
+  "cmd_notation", "cmd_syntax", "cmd_macro_rules",
+]);
+
+function namedChild(node, last) {
+  const children = node.namedChildren.filter((child) => !child.isExtra);
+  return children[last ? children.length - 1 : 0] ?? null;
+}
+
+function commandNode(command) {
+  const cmd = command && namedChild(command, false);
+  if (!cmd) return null;
+  if (cmd.type === "cmd_in") return commandNode(namedChild(cmd, true));
+  if (cmd.type === "cmd_declaration") return namedChild(cmd, true);
+  return cmd;
+}
+
+function findName(node) {
+  for (const child of node.namedChildren) {
+    if (child.type === "decl_ident") return child.firstNamedChild;
+    if (child.type === "ident") return child;
+  }
+  return null;
+}
+
+// The JS equivalent of `outline`, returning plain arrays.
+function jsOutline(parser, source) {
+  const tree = parser.parse(source);
+  const result = { kinds: [], ranges: [], names: [], errors: [] };
+  for (const command of tree.rootNode.namedChildren) {
+    if (command.type !== "command") continue;
+    const node = commandNode(command);
+    if (!node || (node.type.startsWith("cmd_") && !OUTLINE_COMMANDS.has(node.type))) continue;
+    const name = findName(node);
+    result.kinds.push(node.type);
+    result.ranges.push(command.startIndex, command.endIndex);
+    if (name) result.names.push(name.startIndex, name.endIndex);
+    else result.names.push(command.startIndex, command.startIndex);
+  }
+
+  const visit = (node) => {
+    if (node.isError || node.isMissing) result.errors.push(node.startIndex, node.endIndex);
+    if (!node.isMissing && node.hasError) node.children.forEach(visit);
+  };
+  visit(tree.rootNode);
+  return result;
+}
+
+function collect(file, files) {
+  if (fs.statSync(file).isDirectory()) {
+    for (const name of fs.readdirSync(file).sort()) {
+      const child = path.join(file, name);
+      if (fs.statSync(child).isDirectory() || name.endsWith(".lean")) collect(child, files);
+    }
+  } else {
+    files.push(file);
+  }
+  return files;
+}
+
+function time(iterations, fn) {
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < iterations; i++) fn();
+  return Number(process.hrtime.bigint() - start) / 1e6 / iterations;
+}
+
+function main(args) {
+  let iterations = 20;
+  if (args[0] === "-n") {
+    iterations = Math.max(1, parseInt(args[1], 10));
+    args = args.slice(2);
+  }
+  if (!Lean.outline) {
+    console.error("the addon was built without `outline` (is `tree-sitter` installed?)");
+    process.exit(1);
+  }
+
+  const parser = new Parser();
+  parser.setLanguage(Lean);
+  const files = [];
+  for (const arg of args.length ? args : [path.join(__dirname, "..", "corpus")]) collect(arg, files);
+
+  let nativeTotal = 0, jsTotal = 0, bytes = 0;
+  for (const file of files) {
+    const buffer = fs.readFileSync(file);
+    // node-tree-sitter takes strings, and so the JS walk does too
+    const source = buffer.toString();
+
+    const native = Lean.outline(buffer);
+    const js = jsOutline(parser, source);
+    if (native.kinds.length !== js.kinds.length || native.errors.length !== js.errors.length) {
+      console.error(`${file}: the native and JS outlines differ`);
+      process.exit(1);
+    }
+
+    const nativeMs = time(iterations, () => Lean.outline(buffer));
+    const jsMs = time(iterations, () => jsOutline(parser, source));
+    nativeTotal += nativeMs;
+    jsTotal += jsMs;
+    bytes += buffer.length;
+    console.log(
+      `${file}: ${native.kinds.length} entries, native ${nativeMs.toFixed(3)} ms, ` +
+        `JS walk ${jsMs.toFixed(3)} ms (${(jsMs / nativeMs).toFixed(1)}x)`,
+    );
+  }
+
+  const rate = (ms) => (bytes / (ms / 1e3) / 1e6).toFixed(1);
+  console.log(
+    `total: ${files.length} files, native ${rate(nativeTotal)} MB/s, ` +
+      `JS walk ${rate(jsTotal)} MB/s (${(jsTotal / nativeTotal).toFixed(1)}x)`,
+  );
+}
+
+main(process.argv.slice(2));
@@ -0,0 +1,63 @@
+// Measures how outlining a set of files scales with the number of threads in
+// a ParsePool, from 1 up to the number of cores.
+//
+// usage: node bench/node/pool.js [-t max-threads] [-r repeat] [file.lean | dir]...
+//
+// The files are outlined `repeat` times per run, so that small corpora still
+// give every thread enough work.
+
+const fs = require("node:fs");
+const os = require("node:os");
+const path = require("node:path");
+
+const { ParsePool } = require("../../bindings/node");
+
+function collect(file, files) {
+  if (fs.statSync(file).isDirectory()) {
+    for (const name of fs.readdirSync(file).sort()) {
+      const child = path.join(file, name);
+      if (fs.statSync(child).isDirectory() || name.endsWith(".lean")) collect(child, files);
+    }
+  } else {
+    files.push(file);
+  }
+  return files;
+}
+
+async function run(threads, files) {
+  const pool = new ParsePool(threads);
+  // warm up every worker, so that thread startup isn't measured
+  await pool.outlineFiles(files.slice(0, threads));
+  const start = process.hrtime.bigint();
+  await pool.outlineFiles(files);
+  const ms = Number(process.hrtime.bigint() - start) / 1e6;
+  await pool.close();
+  return ms;
+}
+
+async function main(args) {
+  let maxThreads = os.availableParallelism?.() ?? os.cpus().length;
+  let repeat = 10;
+  while (args[0] === "-t" || args[0] === "-r") {
+    if (args[0] === "-t") maxThreads = Math.max(1, parseInt(args[1], 10));
+    else repeat = Math.max(1, parseInt(args[1], 10));
+    args = args.slice(2);
+  }
+
+  const files = [];
+  for (const arg of args.length ? args : [path.join(__dirname, "..", "corpus")]) collect(arg, files);
+  const bytes = files.reduce((sum, file) => sum + fs.statSync(file).size, 0) * repeat;
+  const work = Array.from({ length: repeat }, () => files).flat();
+
+  let base;
+  for (let threads = 1; threads <= maxThreads; threads++) {
+    const ms = await run(threads, work);
+    base ??= ms;
+    console.log(
+      `${threads} threads: ${ms.toFixed(1)} ms, ${(work.length / (ms / 1e3)).toFixed(0)} files/s, ` +
+        `${(bytes / (ms / 1e3) / 1e6).toFixed(1)} MB/s, ${(base / ms).toFixed(2)}x`,
+    );
+  }
+}
+
+main(process.argv.slice(2));
@@ -0,0 +1,110 @@
+// Parse throughput benchmark, also the training run of `make pgo`.
+//
+// Every file is parsed from scratch `iterations` times (after one warm-up
+// parse) and the total throughput is printed on the last line as
+// `total: ... MB/s`, which is what the pgo target compares between builds.
+// With -l, the grammar is loaded from a shared library instead of the one
+// linked in, so that builds of the library can be compared as shipped.
+//
+// usage: parse-bench [-n iterations] [-l libtree-sitter-lean.so] file.lean...
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char *read_file(const char *path, uint32_t *length) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return NULL;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *buffer = malloc(size ? size : 1);
+  if (buffer && fread(buffer, 1, size, f) != (size_t)size) {
+    free(buffer);
+    buffer = NULL;
+  }
+  fclose(f);
+  *length = (uint32_t)size;
+  return buffer;
+}
+
+int main(int argc, char **argv) {
+  unsigned iterations = 20;
+  const char *library = NULL;
+  int first = 1;
+  for (; first + 1 < argc; first += 2) {
+    if (strcmp(argv[first], "-n") == 0)
+      iterations = (unsigned)strtoul(argv[first + 1], NULL, 10);
+    else if (strcmp(argv[first], "-l") == 0)
+      library = argv[first + 1];
+    else
+      break;
+  }
+  if (!iterations)
+    iterations = 1;
+  if (first >= argc) {
+    fprintf(stderr,
+            "usage: %s [-n iterations] [-l library] file.lean...\n",
+            argv[0]);
+    return 2;
+  }
+
+  const TSLanguage *language = tree_sitter_lean();
+  if (library) {
+    void *handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+    const TSLanguage *(*load)(void) =
+        handle ? (const TSLanguage *(*)(void))dlsym(handle, "tree_sitter_lean")
+               : NULL;
+    if (!load) {
+      fprintf(stderr, "%s\n", dlerror());
+      return 1;
+    }
+    language = load();
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, language);
+  uint64_t total_bytes = 0;
+  double total_time = 0;
+
+  for (int a = first; a < argc; a++) {
+    uint32_t length;
+    char *input = read_file(argv[a], &length);
+    if (!input) {
+      perror(argv[a]);
+      return 1;
+    }
+
+    ts_tree_delete(ts_parser_parse_string(parser, NULL, input, length));
+    double start = now();
+    for (unsigned it = 0; it < iterations; it++)
+      ts_tree_delete(ts_parser_parse_string(parser, NULL, input, length));
+    double elapsed = now() - start;
+
+    printf("%s: %.3f ms/iter, %.1f MB/s\n", argv[a],
+           elapsed * 1e3 / iterations,
+           (double)length * iterations / elapsed / 1e6);
+    total_bytes += (uint64_t)length * iterations;
+    total_time += elapsed;
+    free(input);
+  }
+
+  printf("total: %d files, %.3f ms/iter, %.1f MB/s\n", argc - first,
+         total_time * 1e3 / iterations, total_bytes / total_time / 1e6);
+  ts_parser_delete(parser);
+  return 0;
+}
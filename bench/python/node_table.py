@@ -0,0 +1,103 @@
+"""Compares tree_sitter_lean.node_table with building the same columns by
+walking the tree with py-tree-sitter's TreeCursor, row by row in Python.
+
+usage: python bench/python/node_table.py [-n iterations] [file.lean | dir]...
+
+Both sides parse on every iteration. If numpy is installed, the native
+columns are also converted to arrays, to show that this costs nothing.
+"""
+
+import sys
+from array import array
+from pathlib import Path
+from time import perf_counter
+
+import tree_sitter
+import tree_sitter_lean
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+
+def cursor_table(parser, source):
+    tree = parser.parse(source)
+    kind, parent = array("H"), array("i")
+    start_byte, end_byte, named = array("I"), array("I"), array("B")
+    cursor = tree.walk()
+    rows = []
+    while True:
+        node = cursor.node
+        kind.append(node.kind_id)
+        parent.append(rows[-1] if rows else -1)
+        start_byte.append(node.start_byte)
+        end_byte.append(node.end_byte)
+        named.append(node.is_named)
+        if cursor.goto_first_child():
+            rows.append(len(kind) - 1)
+            continue
+        while not cursor.goto_next_sibling():
+            if not cursor.goto_parent():
+                return {"kind": kind, "parent": parent, "start_byte": start_byte,
+                        "end_byte": end_byte, "named": named}
+            rows.pop()
+
+
+def native_table(source):
+    table = tree_sitter_lean.node_table(source)
+    if numpy is not None:
+        table = {name: numpy.asarray(column) for name, column in table.items()}
+    return table
+
+
+def collect(paths):
+    for path in map(Path, paths):
+        if path.is_dir():
+            yield from sorted(path.rglob("*.lean"))
+        else:
+            yield path
+
+
+def timed(iterations, fn):
+    start = perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (perf_counter() - start) / iterations
+
+
+def main(args):
+    iterations = 20
+    if args[:1] == ["-n"]:
+        iterations = max(1, int(args[1]))
+        args = args[2:]
+    if not hasattr(tree_sitter_lean, "node_table"):
+        sys.exit("tree_sitter_lean was built without the tree-sitter runtime")
+
+    parser = tree_sitter.Parser(tree_sitter.Language(tree_sitter_lean.language()))
+    default = Path(__file__).resolve().parent.parent / "corpus"
+    native_total = cursor_total = size = 0
+    for path in collect(args or [default]):
+        source = path.read_bytes()
+        native = tree_sitter_lean.node_table(source)
+        expected = cursor_table(parser, source)
+        if any([int(x) for x in native[name]] != list(column)
+               for name, column in expected.items()):
+            sys.exit(f"{path}: the native and cursor tables differ")
+
+        native_time = timed(iterations, lambda: native_table(source))
+        cursor_time = timed(iterations, lambda: cursor_table(parser, source))
+        native_total += native_time
+        cursor_total += cursor_time
+        size += len(source)
+        print(f"{path}: {len(native['kind'])} nodes, native {native_time * 1e3:.3f} ms, "
+              f"cursor {cursor_time * 1e3:.3f} ms ({cursor_time / native_time:.1f}x)")
+
+    if size:
+        print(f"total: native {size / native_total / 1e6:.1f} MB/s, "
+              f"cursor {size / cursor_total / 1e6:.1f} MB/s "
+              f"({cursor_total / native_total:.1f}x)")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
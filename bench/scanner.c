@@ -0,0 +1,207 @@
+// Microbenchmark for the external scanner's comment path.
+//
+// Every block comment, docstring and module doc in the given files is fed to
+// tree_sitter_lean_external_scanner_scan with only COMMENT_BODY valid, through
+// an in-memory TSLexer. This isolates the cost of scanning comment bodies from
+// the rest of the parse, which is what dominates heavily documented files.
+//
+// usage: scanner-bench [-n iterations] file.lean...
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../src/scanner.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+  TSLexer base;
+  const uint8_t *input;
+  uint32_t length;
+  uint32_t position;
+  uint32_t next_position;
+  uint32_t token_end;
+  uint32_t column;
+} BenchLexer;
+
+static void bench_decode(BenchLexer *self) {
+  if (self->position >= self->length) {
+    self->base.lookahead = 0;
+    self->next_position = self->length;
+    return;
+  }
+  const uint8_t *s = self->input + self->position;
+  uint32_t left = self->length - self->position;
+  int32_t c = s[0];
+  uint32_t size = 1;
+  if (c >= 0xf0 && left >= 4) {
+    c = ((c & 0x07) << 18) | ((s[1] & 0x3f) << 12) | ((s[2] & 0x3f) << 6) |
+        (s[3] & 0x3f);
+    size = 4;
+  } else if (c >= 0xe0 && left >= 3) {
+    c = ((c & 0x0f) << 12) | ((s[1] & 0x3f) << 6) | (s[2] & 0x3f);
+    size = 3;
+  } else if (c >= 0xc0 && left >= 2) {
+    c = ((c & 0x1f) << 6) | (s[1] & 0x3f);
+    size = 2;
+  }
+  self->base.lookahead = c;
+  self->next_position = self->position + size;
+}
+
+static void bench_advance(TSLexer *lexer, bool skip) {
+  BenchLexer *self = (BenchLexer *)lexer;
+  (void)skip;
+  if (self->position >= self->length)
+    return;
+  self->column = lexer->lookahead == '\n' ? 0 : self->column + 1;
+  self->position = self->next_position;
+  bench_decode(self);
+}
+
+static void bench_mark_end(TSLexer *lexer) {
+  BenchLexer *self = (BenchLexer *)lexer;
+  self->token_end = self->position;
+}
+
+static uint32_t bench_get_column(TSLexer *lexer) {
+  return ((BenchLexer *)lexer)->column;
+}
+
+static bool bench_is_at_included_range_start(const TSLexer *lexer) {
+  (void)lexer;
+  return false;
+}
+
+static bool bench_eof(const TSLexer *lexer) {
+  const BenchLexer *self = (const BenchLexer *)lexer;
+  return self->position >= self->length;
+}
+
+static void bench_log(const TSLexer *lexer, const char *format, ...) {
+  (void)lexer;
+  (void)format;
+}
+
+static void bench_reset(BenchLexer *self, uint32_t position) {
+  self->position = position;
+  self->token_end = position;
+  self->column = 0;
+  bench_decode(self);
+}
+
+// Scans every comment body in the input once, returning the number of body
+// bytes consumed by the scanner.
+static uint64_t scan_comments(BenchLexer *lexer, void *scanner,
+                              const bool *valid_symbols) {
+  const uint8_t *s = lexer->input;
+  uint32_t n = lexer->length;
+  uint64_t bytes = 0;
+  uint32_t i = 0;
+  while (i + 1 < n) {
+    if (s[i] == '-' && s[i + 1] == '-') {
+      while (i < n && s[i] != '\n')
+        i++;
+      continue;
+    }
+    if (s[i] != '/' || s[i + 1] != '-') {
+      i++;
+      continue;
+    }
+    i += 2;
+    if (i < n && (s[i] == '-' || s[i] == '!'))
+      i++;
+    bench_reset(lexer, i);
+    if (!tree_sitter_lean_external_scanner_scan(scanner, &lexer->base,
+                                                valid_symbols)) {
+      fprintf(stderr, "scanner rejected comment at byte %u\n", i);
+      exit(1);
+    }
+    bytes += lexer->token_end - i;
+    i = lexer->token_end;
+  }
+  return bytes;
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char *read_file(const char *path, uint32_t *length) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return NULL;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *buffer = malloc(size ? size : 1);
+  if (buffer && fread(buffer, 1, size, f) != (size_t)size) {
+    free(buffer);
+    buffer = NULL;
+  }
+  fclose(f);
+  *length = (uint32_t)size;
+  return buffer;
+}
+
+int main(int argc, char **argv) {
+  unsigned iterations = 1000;
+  int first = 1;
+  if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+    iterations = (unsigned)strtoul(argv[2], NULL, 10);
+    first = 3;
+    if (!iterations)
+      iterations = 1;
+  }
+  if (first >= argc) {
+    fprintf(stderr, "usage: %s [-n iterations] file.lean...\n", argv[0]);
+    return 2;
+  }
+
+  bool valid_symbols[ERROR_SENTINEL + 1] = {false};
+  valid_symbols[COMMENT_BODY] = true;
+  void *scanner = tree_sitter_lean_external_scanner_create();
+
+  for (int a = first; a < argc; a++) {
+    uint32_t length;
+    char *input = read_file(argv[a], &length);
+    if (!input) {
+      perror(argv[a]);
+      return 1;
+    }
+
+    BenchLexer lexer = {
+        .base =
+            {
+                .advance = bench_advance,
+                .mark_end = bench_mark_end,
+                .get_column = bench_get_column,
+                .is_at_included_range_start = bench_is_at_included_range_start,
+                .eof = bench_eof,
+                .log = bench_log,
+            },
+        .input = (const uint8_t *)input,
+        .length = length,
+    };
+
+    uint64_t bytes = 0;
+    double start = now();
+    for (unsigned it = 0; it < iterations; it++)
+      bytes += scan_comments(&lexer, scanner, valid_symbols);
+    double elapsed = now() - start;
+
+    printf("%s: %llu comment bytes/iter (%.0f%% of file), %.3f ms/iter, "
+           "%.1f MB/s\n",
+           argv[a], (unsigned long long)(bytes / iterations),
+           length ? 100.0 * bytes / iterations / length : 0.0,
+           elapsed * 1e3 / iterations, bytes / elapsed / 1e6);
+    free(input);
+  }
+
+  tree_sitter_lean_external_scanner_destroy(scanner);
+  return 0;
+}
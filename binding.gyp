@@ -14,12 +14,39 @@
         "src/scanner.c",
       ],
       "variables": {
-        "has_scanner": "<!(node -p \"fs.existsSync('src/scanner.c')\")"
+        "has_scanner": "<!(node -p \"fs.existsSync('src/scanner.c')\")",
+        # the tree-sitter runtime `outline` links against, found as in setup.py:
+        # a checkout of tree-sitter's `lib` directory named by TREE_SITTER_LIB,
+        # compiled into the addon, or an installed library found with
+        # pkg-config. Without either the addon has no `outline`.
+        "ts_lib": "<!(node -p \"const l = process.env.TREE_SITTER_LIB || ''; if (l && !fs.existsSync(path.join(l, 'src', 'lib.c'))) { console.error('TREE_SITTER_LIB=' + l + ' is not the lib directory of a tree-sitter checkout: ' + path.join(l, 'src', 'lib.c') + ' is missing'); process.exit(1) } l\")",
+        "ts_pkg_config": "<!(node -p \"let found = false; if (!process.env.TREE_SITTER_LIB) { try { child_process.execSync('pkg-config --exists tree-sitter', { stdio: 'ignore' }); found = true } catch (_) { console.error('tree-sitter-lean: no tree-sitter runtime (set TREE_SITTER_LIB or install tree-sitter for pkg-config), building without outline') } } found\")"
       },
       "conditions": [
         ["has_scanner=='true'", {
           "sources+": ["src/scanner.c"],
         }],
+        ["ts_lib!=''", {
+          "sources+": [
+            "<(ts_lib)/src/lib.c",
+            "tools/outline.c",
+          ],
+          "include_dirs+": [
+            "<(ts_lib)/include",
+            "<(ts_lib)/src",
+            "tools",
+          ],
+          "defines": ["TREE_SITTER_LEAN_OUTLINE"],
+        }],
+        ["ts_pkg_config=='true'", {
+          "sources+": ["tools/outline.c"],
+          "include_dirs+": [
+            "<!@(pkg-config --cflags-only-I tree-sitter | sed s/-I//g)",
+            "tools",
+          ],
+          "libraries+": ["<!@(pkg-config --libs tree-sitter)"],
+          "defines": ["TREE_SITTER_LEAN_OUTLINE"],
+        }],
         ["OS!='win'", {
           "cflags_c": [
             "-std=c11",
@@ -0,0 +1,339 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-lean-input.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CHUNK_SIZE TREE_SITTER_LEAN_STREAM_CHUNK_SIZE
+
+int tree_sitter_lean_file_open(TreeSitterLeanFile *file, const char *path) {
+  file->data = "";
+  file->length = 0;
+  file->mapping = NULL;
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return -1;
+  }
+  if ((uint64_t)st.st_size > UINT32_MAX) {
+    close(fd);
+    errno = EFBIG;
+    return -1;
+  }
+  // mmap refuses empty mappings
+  if (st.st_size == 0) {
+    close(fd);
+    return 0;
+  }
+
+  void *mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return -1;
+#ifdef POSIX_MADV_SEQUENTIAL
+  posix_madvise(mapping, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+  file->data = mapping;
+  file->length = (size_t)st.st_size;
+  file->mapping = mapping;
+  return 0;
+}
+
+void tree_sitter_lean_file_close(TreeSitterLeanFile *file) {
+  if (file->mapping)
+    munmap(file->mapping, file->length);
+  file->data = "";
+  file->length = 0;
+  file->mapping = NULL;
+}
+
+static const char *read_file(void *payload, uint32_t byte_index,
+                             TSPoint position, uint32_t *bytes_read) {
+  const TreeSitterLeanFile *file = payload;
+  (void)position;
+  if (byte_index >= file->length) {
+    *bytes_read = 0;
+    return "";
+  }
+  *bytes_read = (uint32_t)(file->length - byte_index);
+  return file->data + byte_index;
+}
+
+TSInput tree_sitter_lean_file_input(const TreeSitterLeanFile *file) {
+  return (TSInput){
+      .payload = (void *)file,
+      .read = read_file,
+      .encoding = TSInputEncodingUTF8,
+  };
+}
+
+TSTree *tree_sitter_lean_parse_file(TSParser *parser, const char *path,
+                                    const TSTree *old_tree) {
+  TreeSitterLeanFile file;
+  if (tree_sitter_lean_file_open(&file, path) != 0)
+    return NULL;
+  TSTree *tree =
+      ts_parser_parse(parser, old_tree, tree_sitter_lean_file_input(&file));
+  tree_sitter_lean_file_close(&file);
+  return tree;
+}
+
+// Every chunk but the last is full, so byte i lives in chunks[i / CHUNK_SIZE].
+typedef struct {
+  int fd;
+  int error;
+  bool eof;
+  char **chunks;
+  uint32_t chunk_count;
+  uint32_t chunk_capacity;
+  uint64_t length;
+  char scratch[4];
+} Stream;
+
+static uint32_t utf8_sequence_length(uint8_t c) {
+  if (c >= 0xf0)
+    return 4;
+  if (c >= 0xe0)
+    return 3;
+  if (c >= 0xc0)
+    return 2;
+  return 1;
+}
+
+// Reads one more chunk, filling it completely unless the stream ends.
+static bool stream_read_chunk(Stream *self) {
+  if (self->length > UINT32_MAX) {
+    self->error = EFBIG;
+    return false;
+  }
+  if (self->chunk_count == self->chunk_capacity) {
+    uint32_t capacity = self->chunk_capacity ? 2 * self->chunk_capacity : 16;
+    char **chunks = realloc(self->chunks, capacity * sizeof(char *));
+    if (!chunks) {
+      self->error = ENOMEM;
+      return false;
+    }
+    self->chunks = chunks;
+    self->chunk_capacity = capacity;
+  }
+  char *chunk = malloc(CHUNK_SIZE);
+  if (!chunk) {
+    self->error = ENOMEM;
+    return false;
+  }
+
+  size_t size = 0;
+  while (size < CHUNK_SIZE) {
+    ssize_t n = read(self->fd, chunk + size, CHUNK_SIZE - size);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0) {
+      self->error = errno;
+      break;
+    }
+    if (n == 0) {
+      self->eof = true;
+      break;
+    }
+    size += (size_t)n;
+  }
+  if (size == 0) {
+    free(chunk);
+    return false;
+  }
+  self->chunks[self->chunk_count++] = chunk;
+  self->length += size;
+  return size == CHUNK_SIZE;
+}
+
+static const char *read_stream(void *payload, uint32_t byte_index,
+                               TSPoint position, uint32_t *bytes_read) {
+  Stream *self = payload;
+  (void)position;
+  // enough to decode the character at byte_index in one piece
+  while (!self->eof && !self->error && self->length < (uint64_t)byte_index + 4)
+    if (!stream_read_chunk(self))
+      break;
+  if (byte_index >= self->length) {
+    *bytes_read = 0;
+    return "";
+  }
+
+  uint32_t offset = byte_index % CHUNK_SIZE;
+  const char *data = self->chunks[byte_index / CHUNK_SIZE] + offset;
+  uint64_t left = self->length - byte_index;
+  uint32_t size = CHUNK_SIZE - offset;
+  if (size >= left) {
+    size = (uint32_t)left;
+    if (self->eof || self->error) {
+      *bytes_read = size;
+      return data;
+    }
+  }
+
+  // the parser decodes each chunk on its own, so stop before a character
+  // that continues in the next one, or hasn't been read yet
+  uint32_t start = size > 4 ? size - 4 : 0;
+  for (uint32_t i = size; i-- > start;) {
+    uint8_t c = (uint8_t)data[i];
+    if ((c & 0xc0) == 0x80)
+      continue;
+    if (i + utf8_sequence_length(c) > size)
+      size = i;
+    break;
+  }
+  if (size > 0) {
+    *bytes_read = size;
+    return data;
+  }
+
+  // the character at byte_index itself straddles two chunks
+  uint32_t length = utf8_sequence_length((uint8_t)*data);
+  if (length > left)
+    length = (uint32_t)left;
+  for (uint32_t i = 0; i < length; i++) {
+    uint64_t index = (uint64_t)byte_index + i;
+    self->scratch[i] = self->chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+  }
+  *bytes_read = length;
+  return self->scratch;
+}
+
+TSTree *tree_sitter_lean_parse_stream(TSParser *parser, int fd,
+                                      const TSTree *old_tree) {
+  Stream stream = {.fd = fd};
+  TSInput input = {
+      .payload = &stream,
+      .read = read_stream,
+      .encoding = TSInputEncodingUTF8,
+  };
+  TSTree *tree = ts_parser_parse(parser, old_tree, input);
+  for (uint32_t i = 0; i < stream.chunk_count; i++)
+    free(stream.chunks[i]);
+  free(stream.chunks);
+
+  if (stream.error) {
+    ts_tree_delete(tree);
+    errno = stream.error;
+    return NULL;
+  }
+  return tree;
+}
+
+// The first words of every command, declaration modifiers included.
+static const char *const COMMAND_KEYWORDS[] = {
+    "abbrev", "add_decl_doc", "attribute", "axiom", "builtin_initialize",
+    "class", "def", "deriving", "end", "example", "export",
+    "gen_injective_theorems%", "import", "include", "inductive", "infix",
+    "infixl", "infixr", "init_quot", "initialize", "instance", "lemma", "local",
+    "macro_rules", "module", "mutual", "namespace", "noncomputable", "norec",
+    "notation", "omit", "opaque", "open", "partial", "postfix", "prefix",
+    "prelude", "private", "protected", "recommended_spelling",
+    "register_tactic_tag", "scoped", "section", "set_option", "structure",
+    "syntax", "tactic_extension", "theorem", "universe", "unsafe", "variable",
+};
+
+static bool is_word_char(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || (c & 0x80);
+}
+
+static bool is_command_line(const char *line, const char *end) {
+  size_t left = (size_t)(end - line);
+  if (left >= 2 && line[0] == '@' && line[1] == '[')
+    return true;
+  if (left >= 3 && line[0] == '/' && line[1] == '-' &&
+      (line[2] == '-' || line[2] == '!'))
+    return true;
+  if (left >= 2 && line[0] == '#' && is_word_char(line[1]))
+    return true;
+
+  size_t n = 0;
+  while (n < left && is_word_char(line[n]))
+    n++;
+  if (n < left && line[n] == '%')
+    n++;
+  if (n == 0 || (n < left && is_word_char(line[n])))
+    return false;
+  for (size_t i = 0; i < sizeof(COMMAND_KEYWORDS) / sizeof(*COMMAND_KEYWORDS);
+       i++) {
+    if (strlen(COMMAND_KEYWORDS[i]) == n &&
+        memcmp(COMMAND_KEYWORDS[i], line, n) == 0)
+      return true;
+  }
+  return false;
+}
+
+uint32_t tree_sitter_lean_command_start(const char *source, uint32_t length,
+                                        uint32_t offset) {
+  if (offset > length)
+    offset = length;
+  uint32_t line = offset;
+  for (;;) {
+    while (line > 0 && source[line - 1] != '\n')
+      line--;
+    if (line == 0 || is_command_line(source + line, source + length))
+      return line;
+    line--;
+  }
+}
+
+uint32_t tree_sitter_lean_next_command_start(const char *source,
+                                             uint32_t length, uint32_t offset) {
+  uint32_t line = offset;
+  while (line < length) {
+    const char *newline = memchr(source + line, '\n', length - line);
+    if (!newline)
+      return length;
+    line = (uint32_t)(newline - source) + 1;
+    if (is_command_line(source + line, source + length))
+      return line;
+  }
+  return length;
+}
+
+static TSPoint point_at(const char *source, uint32_t byte) {
+  TSPoint point = {0, 0};
+  const char *p = source, *end = source + byte, *newline;
+  while ((newline = memchr(p, '\n', (size_t)(end - p)))) {
+    point.row++;
+    p = newline + 1;
+  }
+  point.column = (uint32_t)(end - p);
+  return point;
+}
+
+TSTree *tree_sitter_lean_parse_viewport(TSParser *parser, const char *source,
+                                        uint32_t length, uint32_t offset,
+                                        uint32_t size, TSRange *window) {
+  if (offset > length)
+    offset = length;
+  uint32_t start = tree_sitter_lean_command_start(source, length, offset);
+  uint32_t last = size > length - offset ? length : offset + size;
+  uint32_t end = tree_sitter_lean_next_command_start(source, length, last);
+
+  TSRange range = {
+      .start_point = point_at(source, start),
+      .end_point = point_at(source, end),
+      .start_byte = start,
+      .end_byte = end,
+  };
+  if (window)
+    *window = range;
+
+  ts_parser_set_included_ranges(parser, &range, 1);
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+  ts_parser_set_included_ranges(parser, NULL, 0);
+  return tree;
+}
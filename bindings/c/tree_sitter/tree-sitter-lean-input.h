@@ -0,0 +1,75 @@
+#ifndef TREE_SITTER_LEAN_INPUT_H_
+#define TREE_SITTER_LEAN_INPUT_H_
+
+#include <stddef.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A file mapped into memory, so that it can be parsed (and its text read back
+// through node byte ranges) without copying it.
+typedef struct {
+  const char *data;
+  size_t length;
+  // private
+  void *mapping;
+} TreeSitterLeanFile;
+
+// Maps the file at `path`. Returns 0 on success, or -1 with errno set.
+int tree_sitter_lean_file_open(TreeSitterLeanFile *file, const char *path);
+
+void tree_sitter_lean_file_close(TreeSitterLeanFile *file);
+
+// A TSInput reading straight from the mapping. The file must stay open for as
+// long as the input is in use.
+TSInput tree_sitter_lean_file_input(const TreeSitterLeanFile *file);
+
+// Parses the file at `path` through a memory mapping, returning NULL with
+// errno set if it can't be read. `parser` must be set to tree_sitter_lean().
+TSTree *tree_sitter_lean_parse_file(TSParser *parser, const char *path,
+                                    const TSTree *old_tree);
+
+// Reads at most this many bytes at a time in tree_sitter_lean_parse_stream.
+#define TREE_SITTER_LEAN_STREAM_CHUNK_SIZE 65536
+
+// Parses everything readable from `fd` (a pipe, a socket...), reading it in
+// chunks as the parser asks for it. The chunks are kept until the parse ends,
+// as the parser may revisit earlier positions, but never copied into a
+// contiguous buffer. Returns NULL with errno set if reading fails.
+TSTree *tree_sitter_lean_parse_stream(TSParser *parser, int fd,
+                                      const TSTree *old_tree);
+
+// The start of the nearest line at or before `offset` that begins a top-level
+// command in column 0, such as `theorem`, `@[simp]` or `/--`, or 0 if there is
+// none. Lines are recognized by their first word only, so one inside a block
+// comment or string may be picked too.
+uint32_t tree_sitter_lean_command_start(const char *source, uint32_t length,
+                                        uint32_t offset);
+
+// The start of the first command line after the line containing `offset`, or
+// `length` if there is none, recognized in the same way.
+uint32_t tree_sitter_lean_next_command_start(const char *source,
+                                             uint32_t length, uint32_t offset);
+
+// Parses only the commands covering `[offset, offset + size)`: from
+// tree_sitter_lean_command_start(offset) to the next command start after
+// `offset + size`, or the end of `source`. Nodes keep their positions in the
+// whole source. The parse starts like any other, from an empty scanner state,
+// which is right at a column-0 command. This gives editors a tree for the
+// visible lines long before the whole file is parsed. That full parse should
+// start from scratch (without this tree as the old one) and replace it.
+//
+// The range actually parsed is stored in `window` if it isn't NULL. The
+// parser's included ranges are reset afterwards.
+TSTree *tree_sitter_lean_parse_viewport(TSParser *parser, const char *source,
+                                        uint32_t length, uint32_t offset,
+                                        uint32_t size, TSRange *window);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_LEAN_INPUT_H_
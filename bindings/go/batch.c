@@ -0,0 +1,73 @@
+//go:build lean_batch
+
+#include "../c/tree-sitter-lean-input.c"
+#include "../../tools/outline.c"
+
+#include "batch.h"
+
+#include <errno.h>
+
+typedef Array(uint32_t) Records;
+typedef Array(char) Names;
+
+static void parse_file(TSParser *parser, const char *path, Records *records,
+                       Names *names) {
+  TreeSitterLeanFile file;
+  if (tree_sitter_lean_file_open(&file, path) != 0) {
+    uint32_t header[4] = {(uint32_t)errno, 0, 0, 0};
+    array_extend(records, 4, header);
+    return;
+  }
+
+  TSTree *tree =
+      ts_parser_parse(parser, NULL, tree_sitter_lean_file_input(&file));
+  TSNode root = ts_tree_root_node(tree);
+  LeanOutline outline = array_new();
+  LeanSyntaxErrors errors = array_new();
+  lean_outline_collect(root, &outline);
+  lean_syntax_errors_collect(root, &errors);
+
+  uint32_t header[4] = {0, ts_node_descendant_count(root), outline.size,
+                        errors.size};
+  array_extend(records, 4, header);
+  for (uint32_t i = 0; i < outline.size; i++) {
+    LeanOutlineItem *item = &outline.contents[i];
+    uint32_t length = item->name.end_byte - item->name.start_byte;
+    uint32_t record[4] = {item->symbol, item->range.start_byte,
+                          item->range.end_byte, length};
+    array_extend(records, 4, record);
+    array_extend(names, length, file.data + item->name.start_byte);
+  }
+  for (uint32_t i = 0; i < errors.size; i++) {
+    uint32_t record[2] = {errors.contents[i].range.start_byte,
+                          errors.contents[i].range.end_byte};
+    array_extend(records, 2, record);
+  }
+
+  array_delete(&outline);
+  array_delete(&errors);
+  ts_tree_delete(tree);
+  tree_sitter_lean_file_close(&file);
+}
+
+void lean_batch_parse(const char *paths, uint32_t count, LeanBatch *batch) {
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_lean());
+  Records records = array_new();
+  Names names = array_new();
+  for (uint32_t i = 0; i < count; i++) {
+    parse_file(parser, paths, &records, &names);
+    paths += strlen(paths) + 1;
+  }
+  ts_parser_delete(parser);
+
+  batch->records = records.contents;
+  batch->record_count = records.size;
+  batch->names = names.contents;
+  batch->name_length = names.size;
+}
+
+void lean_batch_free(LeanBatch *batch) {
+  ts_free(batch->records);
+  ts_free(batch->names);
+}
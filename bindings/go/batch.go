@@ -0,0 +1,111 @@
+//go:build lean_batch
+
+package tree_sitter_lean
+
+// #cgo CFLAGS: -I${SRCDIR}/../../src -I${SRCDIR}/../../tools
+// #cgo pkg-config: tree-sitter
+// #include <stdlib.h>
+// #include "batch.h"
+import "C"
+
+import (
+	"os"
+	"runtime"
+	"sync"
+	"syscall"
+	"unsafe"
+)
+
+// The number of files parsed by each cgo call.
+const batchSize = 32
+
+var (
+	symbolNamesOnce sync.Once
+	symbolNames     []string
+)
+
+func kinds() []string {
+	symbolNamesOnce.Do(func() {
+		language := C.tree_sitter_lean()
+		count := uint32(C.ts_language_symbol_count(language))
+		symbolNames = make([]string, count)
+		for i := range symbolNames {
+			symbolNames[i] = C.GoString(C.ts_language_symbol_name(language, C.TSSymbol(i)))
+		}
+	})
+	return symbolNames
+}
+
+// ParseFiles parses files and extracts their outlines, syntax errors and node
+// counts entirely on the C side, so that nothing crosses cgo per node. Files
+// are handed to C in batches, one cgo call each, and up to `workers` batches
+// (one per CPU if workers <= 0) are parsed at once on separate goroutines.
+//
+// The results are in the same order as the paths.
+func ParseFiles(paths []string, workers int) []FileResult {
+	if workers <= 0 {
+		workers = runtime.NumCPU()
+	}
+	results := make([]FileResult, len(paths))
+	batches := make(chan int)
+	var wg sync.WaitGroup
+	for range workers {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for start := range batches {
+				end := min(start+batchSize, len(paths))
+				parseBatch(paths[start:end], results[start:end])
+			}
+		}()
+	}
+	for start := 0; start < len(paths); start += batchSize {
+		batches <- start
+	}
+	close(batches)
+	wg.Wait()
+	return results
+}
+
+func parseBatch(paths []string, results []FileResult) {
+	var buffer []byte
+	for _, path := range paths {
+		buffer = append(buffer, path...)
+		buffer = append(buffer, 0)
+	}
+	var batch C.LeanBatch
+	C.lean_batch_parse((*C.char)(unsafe.Pointer(&buffer[0])), C.uint32_t(len(paths)), &batch)
+	defer C.lean_batch_free(&batch)
+
+	records := unsafe.Slice((*uint32)(unsafe.Pointer(batch.records)), int(batch.record_count))
+	names := unsafe.Slice((*byte)(unsafe.Pointer(batch.names)), int(batch.name_length))
+	kinds := kinds()
+	for i := range results {
+		errno, nodes, n, m := records[0], records[1], records[2], records[3]
+		records = records[4:]
+		result := FileResult{Path: paths[i], Nodes: nodes}
+		if errno != 0 {
+			result.Err = &os.PathError{Op: "open", Path: paths[i], Err: syscall.Errno(errno)}
+		}
+
+		result.Outline = make([]OutlineItem, n)
+		for j := range result.Outline {
+			length := records[3]
+			result.Outline[j] = OutlineItem{
+				Kind:      kinds[records[0]],
+				Name:      string(names[:length]),
+				StartByte: records[1],
+				EndByte:   records[2],
+			}
+			names = names[length:]
+			records = records[4:]
+		}
+
+		result.Errors = make([]ByteRange, m)
+		for j := range result.Errors {
+			result.Errors[j] = ByteRange{StartByte: records[0], EndByte: records[1]}
+			records = records[2:]
+		}
+		results[i] = result
+	}
+}
@@ -0,0 +1,29 @@
+#ifndef TREE_SITTER_LEAN_BATCH_H_
+#define TREE_SITTER_LEAN_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+const TSLanguage *tree_sitter_lean(void);
+
+// For each file, in order:
+//   errno, node count, outline length n, error count m,
+//   n times: symbol, start byte, end byte, name length,
+//   m times: start byte, end byte
+// The names of all outline entries follow each other in `names`.
+typedef struct {
+  uint32_t *records;
+  size_t record_count;
+  char *names;
+  size_t name_length;
+} LeanBatch;
+
+// Parses `count` files whose NUL-terminated paths follow each other in
+// `paths`, with a parser of its own.
+void lean_batch_parse(const char *paths, uint32_t count, LeanBatch *batch);
+
+void lean_batch_free(LeanBatch *batch);
+
+#endif // TREE_SITTER_LEAN_BATCH_H_
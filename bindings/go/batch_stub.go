@@ -0,0 +1,13 @@
+//go:build !lean_batch
+
+package tree_sitter_lean
+
+// ParseFiles needs the tree-sitter runtime, which this package only links
+// when built with the lean_batch tag. Without it every result is ErrNoBatch.
+func ParseFiles(paths []string, workers int) []FileResult {
+	results := make([]FileResult, len(paths))
+	for i, path := range paths {
+		results[i] = FileResult{Path: path, Err: ErrNoBatch}
+	}
+	return results
+}
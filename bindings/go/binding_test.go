@@ -1,6 +1,11 @@
 package tree_sitter_lean_test
 
 import (
+	"errors"
+	"os"
+	"path/filepath"
+	"runtime"
+	"strings"
 	"testing"
 
 	tree_sitter "github.com/tree-sitter/go-tree-sitter"
@@ -13,3 +18,175 @@ func TestCanLoadGrammar(t *testing.T) {
 		t.Errorf("Error loading Lean grammar")
 	}
 }
+
+func TestParseFiles(t *testing.T) {
+	dir := t.TempDir()
+	good := filepath.Join(dir, "good.lean")
+	source := "namespace Foo\ntheorem bar : True := trivial\nend Foo\n"
+	if err := os.WriteFile(good, []byte(source), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	missing := filepath.Join(dir, "missing.lean")
+
+	results := tree_sitter_lean.ParseFiles([]string{good, missing}, 2)
+	if errors.Is(results[0].Err, tree_sitter_lean.ErrNoBatch) {
+		t.Skip(results[0].Err)
+	}
+	if results[0].Err != nil || len(results[0].Errors) != 0 {
+		t.Fatalf("unexpected errors: %v %v", results[0].Err, results[0].Errors)
+	}
+	var names []string
+	for _, item := range results[0].Outline {
+		names = append(names, item.Kind+" "+item.Name)
+	}
+	if got := strings.Join(names, ", "); got != "cmd_namespace Foo, theorem bar" {
+		t.Errorf("outline: %s", got)
+	}
+	if results[1].Err == nil {
+		t.Errorf("expected an error for %s", missing)
+	}
+}
+
+// benchmarkFiles is the benchmark corpus, repeated so that every worker has a
+// few batches to parse.
+func benchmarkFiles(b *testing.B) []string {
+	files, err := filepath.Glob("../../bench/corpus/*/*.lean")
+	if err != nil || len(files) == 0 {
+		b.Skip("no benchmark corpus")
+	}
+	var repeated []string
+	for len(repeated) < 64*runtime.NumCPU() {
+		repeated = append(repeated, files...)
+	}
+	return repeated
+}
+
+func benchmarkParseFiles(b *testing.B, workers int) {
+	files := benchmarkFiles(b)
+	if errors.Is(tree_sitter_lean.ParseFiles(files[:1], 1)[0].Err, tree_sitter_lean.ErrNoBatch) {
+		b.Skip(tree_sitter_lean.ErrNoBatch)
+	}
+	b.ResetTimer()
+	for range b.N {
+		tree_sitter_lean.ParseFiles(files, workers)
+	}
+}
+
+func BenchmarkParseFiles(b *testing.B) {
+	b.Run("workers=1", func(b *testing.B) { benchmarkParseFiles(b, 1) })
+	b.Run("workers=NumCPU", func(b *testing.B) { benchmarkParseFiles(b, 0) })
+}
+
+// walkFile computes what ParseFiles returns by walking the tree from Go, one
+// cgo call (or several) per node.
+func walkFile(parser *tree_sitter.Parser, path string) tree_sitter_lean.FileResult {
+	source, err := os.ReadFile(path)
+	if err != nil {
+		return tree_sitter_lean.FileResult{Path: path, Err: err}
+	}
+	tree := parser.Parse(source, nil)
+	defer tree.Close()
+	result := tree_sitter_lean.FileResult{Path: path}
+
+	cursor := tree.Walk()
+	defer cursor.Close()
+	for depth := 0; ; {
+		node := cursor.Node()
+		result.Nodes++
+		if node.IsError() || node.IsMissing() {
+			result.Errors = append(result.Errors, tree_sitter_lean.ByteRange{
+				StartByte: uint32(node.StartByte()),
+				EndByte:   uint32(node.EndByte()),
+			})
+		}
+		if depth == 1 && node.Kind() == "command" {
+			if item, ok := outlineItem(node, source); ok {
+				result.Outline = append(result.Outline, item)
+			}
+		}
+		if cursor.GotoFirstChild() {
+			depth++
+			continue
+		}
+		for !cursor.GotoNextSibling() {
+			if !cursor.GotoParent() {
+				return result
+			}
+			depth--
+		}
+	}
+}
+
+func firstNamedChild(node *tree_sitter.Node, last bool) *tree_sitter.Node {
+	count := node.NamedChildCount()
+	for i := uint(0); i < count; i++ {
+		index := i
+		if last {
+			index = count - 1 - i
+		}
+		if child := node.NamedChild(index); !child.IsExtra() {
+			return child
+		}
+	}
+	return nil
+}
+
+func commandNode(command *tree_sitter.Node) *tree_sitter.Node {
+	if command == nil {
+		return nil
+	}
+	cmd := firstNamedChild(command, false)
+	switch {
+	case cmd == nil:
+		return nil
+	case cmd.Kind() == "cmd_in":
+		return commandNode(firstNamedChild(cmd, true))
+	case cmd.Kind() == "cmd_declaration":
+		return firstNamedChild(cmd, true)
+	}
+	return cmd
+}
+
+var outlineCommands = map[string]bool{
+	"cmd_namespace": true, "cmd_section": true, "cmd_noncomputable_section": true,
+	"cmd_initialize": true, "cmd_mutual": true, "cmd_mixfix": true,
+	"cmd_notation": true, "cmd_syntax": true, "cmd_macro_rules": true,
+}
+
+func outlineItem(command *tree_sitter.Node, source []byte) (tree_sitter_lean.OutlineItem, bool) {
+	node := commandNode(command)
+	if node == nil || (strings.HasPrefix(node.Kind(), "cmd_") && !outlineCommands[node.Kind()]) {
+		return tree_sitter_lean.OutlineItem{}, false
+	}
+	item := tree_sitter_lean.OutlineItem{
+		Kind:      node.Kind(),
+		StartByte: uint32(command.StartByte()),
+		EndByte:   uint32(command.EndByte()),
+	}
+	for i := uint(0); i < node.NamedChildCount(); i++ {
+		child := node.NamedChild(i)
+		if child.Kind() == "decl_ident" {
+			child = child.NamedChild(0)
+		} else if child.Kind() != "ident" {
+			continue
+		}
+		item.Name = child.Utf8Text(source)
+		break
+	}
+	return item, true
+}
+
+func BenchmarkWalk(b *testing.B) {
+	files := benchmarkFiles(b)
+	parser := tree_sitter.NewParser()
+	defer parser.Close()
+	if err := parser.SetLanguage(tree_sitter.NewLanguage(tree_sitter_lean.Language())); err != nil {
+		b.Fatal(err)
+	}
+	b.ResetTimer()
+	for range b.N {
+		for _, file := range files {
+			walkFile(parser, file)
+		}
+	}
+}
@@ -0,0 +1,36 @@
+package tree_sitter_lean
+
+import "errors"
+
+// OutlineItem is a top-level declaration, namespace, section or syntax
+// extension.
+type OutlineItem struct {
+	// The node type that best describes the entry, such as "theorem" or
+	// "cmd_namespace".
+	Kind string
+	// Empty for anonymous entries such as `example`.
+	Name      string
+	StartByte uint32
+	EndByte   uint32
+}
+
+// ByteRange is the span of an ERROR or MISSING node.
+type ByteRange struct {
+	StartByte uint32
+	EndByte   uint32
+}
+
+// FileResult is what ParseFiles extracts from one file.
+type FileResult struct {
+	Path string
+	// Set if the file couldn't be read.
+	Err     error
+	Outline []OutlineItem
+	Errors  []ByteRange
+	// The number of nodes in the tree.
+	Nodes uint32
+}
+
+// ErrNoBatch is returned for every file by ParseFiles when the package was
+// built without the lean_batch tag.
+var ErrNoBatch = errors.New("tree_sitter_lean: ParseFiles needs the lean_batch build tag")
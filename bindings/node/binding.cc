@@ -1,5 +1,11 @@
 #include <napi.h>
 
+#ifdef TREE_SITTER_LEAN_OUTLINE
+#include <string>
+
+#include "outline.h"
+#endif
+
 typedef struct TSLanguage TSLanguage;
 
 extern "C" TSLanguage *tree_sitter_lean();
@@ -9,10 +15,106 @@ const napi_type_tag LANGUAGE_TYPE_TAG = {
     0x8AF2E5212AD58ABF, 0xD5006CAD83ABBA16
 };
 
+#ifdef TREE_SITTER_LEAN_OUTLINE
+
+// One parser per thread (main thread or worker), created with the module.
+static void DeleteParser(Napi::Env, TSParser *parser) {
+    ts_parser_delete(parser);
+}
+
+// outline(source) parses a string or Uint8Array and returns its outline and
+// syntax errors as flat Uint32Arrays, all views of a single ArrayBuffer:
+//
+//   kinds   symbol of each entry (an index into `symbolNames`)
+//   ranges  [start, end) bytes of each entry's command
+//   names   [start, end) bytes of each entry's name, empty if it has none
+//   errors  [start, end) bytes of each ERROR or MISSING node
+//
+// No JS object is created per node, so this is much cheaper than walking a
+// tree from JS when only the outline is needed.
+static Napi::Value Outline(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    std::string string;
+    const char *text;
+    size_t length;
+    if (info[0].IsTypedArray() &&
+        info[0].As<Napi::TypedArray>().TypedArrayType() == napi_uint8_array) {
+        auto bytes = info[0].As<Napi::Uint8Array>();
+        text = reinterpret_cast<const char *>(bytes.Data());
+        length = bytes.ByteLength();
+    } else if (info[0].IsString()) {
+        string = info[0].As<Napi::String>().Utf8Value();
+        text = string.data();
+        length = string.size();
+    } else {
+        throw Napi::TypeError::New(env, "source must be a string or a Uint8Array");
+    }
+    if (length > UINT32_MAX) {
+        throw Napi::RangeError::New(env, "source is larger than 4 GiB");
+    }
+
+    TSParser *parser = env.GetInstanceData<TSParser>();
+    TSTree *tree = ts_parser_parse_string(parser, nullptr, text, (uint32_t)length);
+    TSNode root = ts_tree_root_node(tree);
+    LeanOutline outline = array_new();
+    LeanSyntaxErrors errors = array_new();
+    lean_outline_collect(root, &outline);
+    lean_syntax_errors_collect(root, &errors);
+    ts_tree_delete(tree);
+
+    size_t n = outline.size, m = errors.size;
+    auto buffer = Napi::ArrayBuffer::New(env, (5 * n + 2 * m) * sizeof(uint32_t));
+    auto kinds = Napi::Uint32Array::New(env, n, buffer, 0);
+    auto ranges = Napi::Uint32Array::New(env, 2 * n, buffer, n * sizeof(uint32_t));
+    auto names = Napi::Uint32Array::New(env, 2 * n, buffer, 3 * n * sizeof(uint32_t));
+    auto error_ranges = Napi::Uint32Array::New(env, 2 * m, buffer, 5 * n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) {
+        const LeanOutlineItem *item = &outline.contents[i];
+        kinds[i] = item->symbol;
+        ranges[2 * i] = item->range.start_byte;
+        ranges[2 * i + 1] = item->range.end_byte;
+        names[2 * i] = item->name.start_byte;
+        names[2 * i + 1] = item->name.end_byte;
+    }
+    for (size_t i = 0; i < m; i++) {
+        error_ranges[2 * i] = errors.contents[i].range.start_byte;
+        error_ranges[2 * i + 1] = errors.contents[i].range.end_byte;
+    }
+    array_delete(&outline);
+    array_delete(&errors);
+
+    auto result = Napi::Object::New(env);
+    result["kinds"] = kinds;
+    result["ranges"] = ranges;
+    result["names"] = names;
+    result["errors"] = error_ranges;
+    return result;
+}
+
+static void InitOutline(Napi::Env env, Napi::Object exports) {
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_lean());
+    env.SetInstanceData<TSParser, DeleteParser>(parser);
+
+    const TSLanguage *language = tree_sitter_lean();
+    uint32_t count = ts_language_symbol_count(language);
+    auto symbol_names = Napi::Array::New(env, count);
+    for (uint32_t i = 0; i < count; i++) {
+        symbol_names[i] = Napi::String::New(env, ts_language_symbol_name(language, (TSSymbol)i));
+    }
+    exports["symbolNames"] = symbol_names;
+    exports["outline"] = Napi::Function::New(env, Outline, "outline");
+}
+
+#endif
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     auto language = Napi::External<TSLanguage>::New(env, tree_sitter_lean());
     language.TypeTag(&LANGUAGE_TYPE_TAG);
     exports["language"] = language;
+#ifdef TREE_SITTER_LEAN_OUTLINE
+    InitOutline(env, exports);
+#endif
     return exports;
 }
 
@@ -7,3 +7,30 @@ test("can load grammar", () => {
   const parser = new Parser();
   assert.doesNotThrow(() => parser.setLanguage(require(".")));
 });
+
+test("outline", { skip: !require(".").outline }, () => {
+  const { outline, symbolNames } = require(".");
+  const source = Buffer.from("namespace Foo\ntheorem bar : True := trivial\nend Foo\n");
+  const { kinds, names, errors } = outline(source);
+  assert.deepStrictEqual(
+    Array.from(kinds, (kind) => symbolNames[kind]),
+    ["cmd_namespace", "theorem"],
+  );
+  assert.strictEqual(source.subarray(names[0], names[1]).toString(), "Foo");
+  assert.strictEqual(source.subarray(names[2], names[3]).toString(), "bar");
+  assert.strictEqual(errors.length, 0);
+});
+
+test("parse pool", { skip: !require(".").outline }, async () => {
+  const { ParsePool, outline } = require(".");
+  const file = require("node:path").join(__dirname, "..", "..", "bench", "corpus", "train", "docs.lean");
+  const pool = new ParsePool(2);
+  try {
+    const [a, b] = await pool.outlineFiles([file, file]);
+    const expected = outline(require("node:fs").readFileSync(file));
+    assert.deepStrictEqual(a, expected);
+    assert.deepStrictEqual(b, expected);
+  } finally {
+    await pool.close();
+  }
+});
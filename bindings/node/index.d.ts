@@ -18,9 +18,46 @@ type NodeInfo =
       children: ChildNode[];
     });
 
+/**
+ * The outline of a file as flat arrays of byte offsets, all views of one
+ * ArrayBuffer. Entry `i` has kind `symbolNames[kinds[i]]`, spans
+ * `ranges[2 * i]..ranges[2 * i + 1]` and is named by
+ * `names[2 * i]..names[2 * i + 1]` (empty for anonymous entries).
+ */
+type Outline = {
+  kinds: Uint32Array;
+  ranges: Uint32Array;
+  names: Uint32Array;
+  /** `[start, end)` byte pairs of every ERROR and MISSING node */
+  errors: Uint32Array;
+};
+
+/**
+ * Outlines files on a pool of worker threads, each with its own parser. The
+ * outlines come back as transferred ArrayBuffers rather than cloned objects.
+ * Idle workers don't keep the process alive.
+ */
+declare class ParsePool {
+  /** Defaults to one thread per core. */
+  constructor(threads?: number);
+  readonly threads: number;
+  outlineFile(file: string): Promise<Outline>;
+  outlineFiles(files: string[]): Promise<Outline[]>;
+  close(): Promise<void>;
+}
+
 type Language = {
   language: unknown;
   nodeTypeInfo: NodeInfo[];
+  /**
+   * Parses `source` natively and returns its outline, without creating a JS
+   * object per node. Only present when the addon was built against a
+   * tree-sitter runtime: a checkout's `lib` directory named by TREE_SITTER_LIB,
+   * or an installed library found with pkg-config.
+   */
+  outline?: (source: string | Uint8Array) => Outline;
+  symbolNames?: string[];
+  ParsePool: typeof ParsePool;
 };
 
 declare const language: Language;
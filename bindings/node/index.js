@@ -9,3 +9,5 @@ module.exports =
 try {
   module.exports.nodeTypeInfo = require("../../src/node-types.json");
 } catch (_) {}
+
+module.exports.ParsePool = require("./pool").ParsePool;
@@ -0,0 +1,112 @@
+const os = require("node:os");
+const path = require("node:path");
+const { Worker } = require("node:worker_threads");
+
+// Views over the ArrayBuffer returned by the native `outline`, laid out as
+// kinds (n), ranges (2n), names (2n) and errors (2m).
+function outlineViews(buffer, n, m) {
+  return {
+    kinds: new Uint32Array(buffer, 0, n),
+    ranges: new Uint32Array(buffer, 4 * n, 2 * n),
+    names: new Uint32Array(buffer, 12 * n, 2 * n),
+    errors: new Uint32Array(buffer, 20 * n, 2 * m),
+  };
+}
+
+// Outlines files on a pool of worker threads, each with its own parser.
+// Workers read the files themselves and transfer the outline's ArrayBuffer
+// back, so nothing is copied or structured-cloned on the way.
+class ParsePool {
+  constructor(threads = os.availableParallelism?.() ?? os.cpus().length) {
+    if (!require(".").outline) {
+      throw new Error("the addon was built without `outline` (is `tree-sitter` installed?)");
+    }
+    this.workers = [];
+    this.idle = [];
+    this.queue = [];
+    this.jobs = new Map();
+    this.nextId = 0;
+    for (let i = 0; i < Math.max(1, threads); i++) {
+      const worker = new Worker(path.join(__dirname, "pool_worker.js"));
+      worker.on("message", (message) => this.done(worker, message));
+      worker.on("error", (error) => this.fail(worker, error));
+      // a worker can also exit without an error, e.g. on process.exit()
+      worker.on("exit", (code) =>
+        this.fail(worker, new Error(`a parse worker exited with code ${code}`)),
+      );
+      worker.unref();
+      this.workers.push(worker);
+      this.idle.push(worker);
+    }
+  }
+
+  get threads() {
+    return this.workers.length;
+  }
+
+  // Resolves to the outline of `file`, as returned by `outline`.
+  outlineFile(file) {
+    return new Promise((resolve, reject) => {
+      this.queue.push({ id: this.nextId++, file, resolve, reject });
+      this.schedule();
+    });
+  }
+
+  outlineFiles(files) {
+    return Promise.all(files.map((file) => this.outlineFile(file)));
+  }
+
+  async close() {
+    const workers = this.workers;
+    this.workers = [];
+    this.idle = [];
+    await Promise.all(workers.map((worker) => worker.terminate()));
+    for (const job of [...this.jobs.values(), ...this.queue]) {
+      job.reject(new Error("the pool was closed"));
+    }
+    this.jobs.clear();
+    this.queue = [];
+  }
+
+  schedule() {
+    while (this.idle.length && this.queue.length) {
+      const worker = this.idle.pop();
+      const job = this.queue.shift();
+      job.worker = worker;
+      this.jobs.set(job.id, job);
+      // only busy workers keep the process alive
+      worker.ref();
+      worker.postMessage({ id: job.id, file: job.file });
+    }
+  }
+
+  done(worker, { id, buffer, n, m, error }) {
+    const job = this.jobs.get(id);
+    this.jobs.delete(id);
+    worker.unref();
+    this.idle.push(worker);
+    if (error) job.reject(new Error(error));
+    else job.resolve(outlineViews(buffer, n, m));
+    this.schedule();
+  }
+
+  // A worker that dies takes its job with it; the others carry on. Called
+  // for both `error` and the `exit` that follows it, and for workers that
+  // `close` terminated, so only the first call for a live worker counts.
+  fail(worker, error) {
+    if (!this.workers.includes(worker)) return;
+    for (const [id, job] of this.jobs) {
+      if (job.worker !== worker) continue;
+      this.jobs.delete(id);
+      job.reject(error);
+    }
+    this.workers = this.workers.filter((w) => w !== worker);
+    this.idle = this.idle.filter((w) => w !== worker);
+    if (!this.workers.length) {
+      for (const job of this.queue) job.reject(error);
+      this.queue = [];
+    }
+  }
+}
+
+module.exports = { ParsePool, outlineViews };
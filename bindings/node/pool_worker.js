@@ -0,0 +1,18 @@
+const fs = require("node:fs");
+const { parentPort } = require("node:worker_threads");
+
+// the addon gives every thread its own parser
+const { outline } = require(".");
+
+parentPort.on("message", ({ id, file }) => {
+  try {
+    const { kinds, errors } = outline(fs.readFileSync(file));
+    const buffer = kinds.buffer;
+    parentPort.postMessage(
+      { id, buffer, n: kinds.length, m: errors.length / 2 },
+      [buffer],
+    );
+  } catch (error) {
+    parentPort.postMessage({ id, error: `${file}: ${error.message}` });
+  }
+});
@@ -1,3 +1,5 @@
+from os import path
+from tempfile import TemporaryDirectory
 from unittest import TestCase
 
 import tree_sitter
@@ -10,3 +12,39 @@ class TestLanguage(TestCase):
             tree_sitter.Language(tree_sitter_lean.language())
         except Exception:
             self.fail("Error loading Lean grammar")
+
+
+class TestNative(TestCase):
+    def setUp(self):
+        if not hasattr(tree_sitter_lean, "parse_many"):
+            self.skipTest("built without the tree-sitter runtime")
+
+    def test_outline(self):
+        with TemporaryDirectory() as tmp:
+            good = path.join(tmp, "good.lean")
+            with open(good, "w") as f:
+                f.write("namespace Foo\ntheorem bar : True := trivial\nend Foo\n")
+            missing = path.join(tmp, "missing.lean")
+            [result, failed] = tree_sitter_lean.parse_many([good, missing], threads=2)
+
+        self.assertIsNone(result["error"])
+        self.assertEqual(
+            [(kind, name) for kind, name, _, _ in result["outline"]],
+            [("cmd_namespace", "Foo"), ("theorem", "bar")],
+        )
+        self.assertEqual(result["errors"], [])
+        self.assertGreater(result["nodes"], 0)
+        self.assertIsNotNone(failed["error"])
+
+    def test_node_table(self):
+        source = b"theorem foo : True := trivial\n"
+        table = tree_sitter_lean.node_table(source)
+        names = tree_sitter_lean.symbol_names()
+
+        rows = len(table["kind"])
+        self.assertTrue(all(len(column) == rows for column in table.values()))
+        self.assertEqual(names[table["kind"][0]], "module")
+        self.assertEqual(table["parent"][0], -1)
+        self.assertTrue(all(table["parent"][i] < i for i in range(1, rows)))
+        self.assertEqual(table["end_byte"][0], len(source))
+        self.assertIn("theorem", [names[k] for k, named in zip(table["kind"], table["named"]) if named])
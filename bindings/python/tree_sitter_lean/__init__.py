@@ -4,6 +4,11 @@ from importlib.resources import files as _files
 
 from ._binding import language
 
+try:
+    from ._binding import node_table, parse_many, symbol_names
+except ImportError:  # built without the tree-sitter runtime
+    pass
+
 
 def _get_query(name, file):
     query = _files(f"{__package__}.queries") / file
@@ -16,8 +21,8 @@ def __getattr__(name):
 
     # if name == "HIGHLIGHTS_QUERY":
     #     return _get_query("HIGHLIGHTS_QUERY", "highlights.scm")
-    # if name == "INJECTIONS_QUERY":
-    #     return _get_query("INJECTIONS_QUERY", "injections.scm")
+    if name == "INJECTIONS_QUERY":
+        return _get_query("INJECTIONS_QUERY", "injections.scm")
     # if name == "LOCALS_QUERY":
     #     return _get_query("LOCALS_QUERY", "locals.scm")
     # if name == "TAGS_QUERY":
@@ -29,10 +34,12 @@ def __getattr__(name):
 __all__ = [
     "language",
     # "HIGHLIGHTS_QUERY",
-    # "INJECTIONS_QUERY",
+    "INJECTIONS_QUERY",
     # "LOCALS_QUERY",
     # "TAGS_QUERY",
 ]
+if "parse_many" in globals():
+    __all__.extend(["node_table", "parse_many", "symbol_names"])
 
 
 def __dir__():
@@ -1,10 +1,39 @@
-from typing import Final
+from os import PathLike
+from typing import Final, Iterable, Literal, TypedDict
 
 # NOTE: uncomment these to include any queries that this grammar contains:
 
 # HIGHLIGHTS_QUERY: Final[str]
-# INJECTIONS_QUERY: Final[str]
+INJECTIONS_QUERY: Final[str]
 # LOCALS_QUERY: Final[str]
 # TAGS_QUERY: Final[str]
 
 def language() -> object: ...
+
+class ParseResult(TypedDict):
+    path: str | bytes | PathLike[str] | PathLike[bytes]
+    error: str | None
+    # (kind, name, start byte, end byte) of each declaration, namespace, ...
+    outline: list[tuple[str, str | None, int, int]]
+    # (start byte, end byte) of each ERROR or MISSING node
+    errors: list[tuple[int, int]]
+    nodes: int
+
+# Only available when built against the tree-sitter runtime.
+def parse_many(
+    paths: Iterable[str | bytes | PathLike[str] | PathLike[bytes]],
+    threads: int | None = None,
+) -> list[ParseResult]: ...
+
+# Columns of memoryviews over the nodes of a tree, in pre-order:
+#   kind        uint16 ("H"), an index into symbol_names()
+#   parent      int32 ("i"), the row of the parent, -1 for the root
+#   start_byte  uint32 ("I")
+#   end_byte    uint32 ("I")
+#   named       bool ("?")
+# numpy.asarray and pyarrow.py_buffer use them without copying.
+def node_table(
+    source: bytes | str,
+) -> dict[Literal["kind", "parent", "start_byte", "end_byte", "named"], memoryview]: ...
+
+def symbol_names() -> list[str]: ...
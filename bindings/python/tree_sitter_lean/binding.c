@@ -8,6 +8,353 @@ static PyObject* _binding_language(PyObject *Py_UNUSED(self), PyObject *Py_UNUSE
     return PyCapsule_New(tree_sitter_lean(), "tree_sitter.Language", NULL);
 }
 
+#ifdef TREE_SITTER_LEAN_RUNTIME
+
+#include "outline.h"
+#include "tree_sitter/tree-sitter-lean-input.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    PyObject *path;
+    const char *filename;
+    int error;
+    LeanOutline outline;
+    LeanSyntaxErrors errors;
+    // the names of the outline entries, one after the other
+    Array(char) names;
+    uint32_t nodes;
+} ParseJob;
+
+typedef struct {
+    ParseJob *jobs;
+    size_t count;
+    atomic_size_t next;
+} ParseQueue;
+
+static void parse_job(TSParser *parser, ParseJob *job) {
+    TreeSitterLeanFile file;
+    if (tree_sitter_lean_file_open(&file, job->filename) != 0) {
+        job->error = errno;
+        return;
+    }
+    TSTree *tree = ts_parser_parse(parser, NULL, tree_sitter_lean_file_input(&file));
+    TSNode root = ts_tree_root_node(tree);
+    lean_outline_collect(root, &job->outline);
+    lean_syntax_errors_collect(root, &job->errors);
+    job->nodes = ts_node_descendant_count(root);
+    for (uint32_t i = 0; i < job->outline.size; i++) {
+        TSRange name = job->outline.contents[i].name;
+        array_extend(&job->names, name.end_byte - name.start_byte, file.data + name.start_byte);
+    }
+    ts_tree_delete(tree);
+    tree_sitter_lean_file_close(&file);
+}
+
+// Each thread takes the next file until there are none left.
+static void *parse_worker(void *payload) {
+    ParseQueue *queue = payload;
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_lean());
+    for (size_t i; (i = atomic_fetch_add(&queue->next, 1)) < queue->count;) {
+        parse_job(parser, &queue->jobs[i]);
+    }
+    ts_parser_delete(parser);
+    return NULL;
+}
+
+static PyObject *job_result(ParseJob *job, PyObject **kinds) {
+    const TSLanguage *language = tree_sitter_lean();
+    PyObject *error = Py_None, *outline = NULL, *errors = NULL;
+    if (job->error) {
+        error = PyUnicode_FromString(strerror(job->error));
+    } else {
+        Py_INCREF(error);
+    }
+    if (!error || !(outline = PyList_New(job->outline.size)) ||
+        !(errors = PyList_New(job->errors.size))) {
+        goto fail;
+    }
+
+    const char *name = job->names.contents;
+    for (uint32_t i = 0; i < job->outline.size; i++) {
+        LeanOutlineItem *item = &job->outline.contents[i];
+        PyObject **kind = &kinds[item->symbol];
+        if (!*kind && !(*kind = PyUnicode_InternFromString(ts_language_symbol_name(language, item->symbol)))) {
+            goto fail;
+        }
+        uint32_t length = item->name.end_byte - item->name.start_byte;
+        PyObject *entry = Py_BuildValue(
+            "(ON II)", *kind,
+            length ? PyUnicode_DecodeUTF8(name, length, "replace") : Py_NewRef(Py_None),
+            item->range.start_byte, item->range.end_byte);
+        if (!entry) {
+            goto fail;
+        }
+        PyList_SetItem(outline, i, entry);
+        name += length;
+    }
+    for (uint32_t i = 0; i < job->errors.size; i++) {
+        TSRange range = job->errors.contents[i].range;
+        PyObject *entry = Py_BuildValue("(II)", range.start_byte, range.end_byte);
+        if (!entry) {
+            goto fail;
+        }
+        PyList_SetItem(errors, i, entry);
+    }
+
+    return Py_BuildValue("{sO sN sN sN sI}", "path", job->path, "error", error,
+                         "outline", outline, "errors", errors, "nodes", job->nodes);
+
+fail:
+    Py_XDECREF(error);
+    Py_XDECREF(outline);
+    Py_XDECREF(errors);
+    return NULL;
+}
+
+static PyObject *_binding_parse_many(PyObject *Py_UNUSED(self), PyObject *args, PyObject *kwargs) {
+    static char *keywords[] = {"paths", "threads", NULL};
+    PyObject *paths, *threads_arg = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O:parse_many", keywords, &paths, &threads_arg)) {
+        return NULL;
+    }
+    long threads = 0;
+    if (threads_arg != Py_None) {
+        threads = PyLong_AsLong(threads_arg);
+        if (threads == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (threads < 1) {
+            PyErr_SetString(PyExc_ValueError, "threads must be at least 1");
+            return NULL;
+        }
+    } else {
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+        if (threads < 1) {
+            threads = 1;
+        }
+    }
+
+    PyObject *list = PySequence_List(paths);
+    if (!list) {
+        return NULL;
+    }
+    Py_ssize_t count = PyList_Size(list);
+    ParseJob *jobs = PyMem_Calloc(count ? (size_t)count : 1, sizeof(ParseJob));
+    PyObject *encoded = PyList_New(count);
+    PyObject *result = NULL;
+    if (!jobs || !encoded) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *bytes;
+        if (!PyUnicode_FSConverter(PyList_GetItem(list, i), &bytes)) {
+            goto done;
+        }
+        PyList_SetItem(encoded, i, bytes);
+        jobs[i].path = PyList_GetItem(list, i);
+        jobs[i].filename = PyBytes_AsString(bytes);
+    }
+
+    ParseQueue queue = {.jobs = jobs, .count = (size_t)count};
+    atomic_init(&queue.next, 0);
+    if (threads > count) {
+        threads = count ? (long)count : 1;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    // the calling thread is one of the workers
+    pthread_t *workers = malloc((size_t)threads * sizeof(pthread_t));
+    long started = 0;
+    while (workers && started < threads - 1 &&
+           pthread_create(&workers[started], NULL, parse_worker, &queue) == 0) {
+        started++;
+    }
+    parse_worker(&queue);
+    for (long i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    Py_END_ALLOW_THREADS
+
+    const TSLanguage *language = tree_sitter_lean();
+    uint32_t symbol_count = ts_language_symbol_count(language);
+    PyObject **kinds = PyMem_Calloc(symbol_count, sizeof(PyObject *));
+    if (!kinds || !(result = PyList_New(count))) {
+        PyErr_NoMemory();
+    } else {
+        for (Py_ssize_t i = 0; i < count; i++) {
+            PyObject *item = job_result(&jobs[i], kinds);
+            if (!item) {
+                Py_CLEAR(result);
+                break;
+            }
+            PyList_SetItem(result, i, item);
+        }
+    }
+    if (kinds) {
+        for (uint32_t i = 0; i < symbol_count; i++) {
+            Py_XDECREF(kinds[i]);
+        }
+        PyMem_Free(kinds);
+    }
+
+done:
+    if (jobs) {
+        for (Py_ssize_t i = 0; i < count; i++) {
+            array_delete(&jobs[i].outline);
+            array_delete(&jobs[i].errors);
+            array_delete(&jobs[i].names);
+        }
+        PyMem_Free(jobs);
+    }
+    Py_XDECREF(encoded);
+    Py_DECREF(list);
+    return result;
+}
+
+// A column of the node table: a bytes object filled in place, then exposed as
+// a memoryview with the element format numpy and arrow expect.
+typedef struct {
+    const char *name;
+    const char *format;
+    size_t size;
+    PyObject *bytes;
+    void *data;
+} Column;
+
+enum { KIND, PARENT, START_BYTE, END_BYTE, NAMED, COLUMN_COUNT };
+
+// Fills the columns in pre-order, so that a parent always comes before its
+// children. Runs without the GIL.
+static void fill_node_table(TSNode root, Column *columns, uint32_t count) {
+    uint16_t *kinds = columns[KIND].data;
+    int32_t *parents = columns[PARENT].data;
+    uint32_t *starts = columns[START_BYTE].data;
+    uint32_t *ends = columns[END_BYTE].data;
+    bool *named = columns[NAMED].data;
+
+    // the row of each node on the path from the root to the cursor
+    Array(int32_t) path = array_new();
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    for (uint32_t row = 0; row < count; row++) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        kinds[row] = ts_node_symbol(node);
+        parents[row] = path.size ? path.contents[path.size - 1] : -1;
+        starts[row] = ts_node_start_byte(node);
+        ends[row] = ts_node_end_byte(node);
+        named[row] = ts_node_is_named(node);
+
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            array_push(&path, (int32_t)row);
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                goto done;
+            }
+            path.size--;
+        }
+    }
+done:
+    ts_tree_cursor_delete(&cursor);
+    array_delete(&path);
+}
+
+static PyObject *_binding_node_table(PyObject *Py_UNUSED(self), PyObject *source) {
+    const char *text;
+    Py_ssize_t length;
+    if (PyBytes_Check(source)) {
+        if (PyBytes_AsStringAndSize(source, (char **)&text, &length) < 0) {
+            return NULL;
+        }
+    } else if (PyUnicode_Check(source)) {
+        if (!(text = PyUnicode_AsUTF8AndSize(source, &length))) {
+            return NULL;
+        }
+    } else {
+        PyErr_SetString(PyExc_TypeError, "source must be bytes or str");
+        return NULL;
+    }
+    if ((size_t)length > UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "source is larger than 4 GiB");
+        return NULL;
+    }
+
+    TSTree *tree;
+    uint32_t count;
+    Py_BEGIN_ALLOW_THREADS
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_lean());
+    tree = ts_parser_parse_string(parser, NULL, text, (uint32_t)length);
+    ts_parser_delete(parser);
+    count = ts_node_descendant_count(ts_tree_root_node(tree));
+    Py_END_ALLOW_THREADS
+
+    Column columns[COLUMN_COUNT] = {
+        [KIND] = {"kind", "H", sizeof(uint16_t)},
+        [PARENT] = {"parent", "i", sizeof(int32_t)},
+        [START_BYTE] = {"start_byte", "I", sizeof(uint32_t)},
+        [END_BYTE] = {"end_byte", "I", sizeof(uint32_t)},
+        [NAMED] = {"named", "?", sizeof(bool)},
+    };
+    PyObject *result = NULL;
+    for (int i = 0; i < COLUMN_COUNT; i++) {
+        if (!(columns[i].bytes = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(count * columns[i].size)))) {
+            goto done;
+        }
+        columns[i].data = PyBytes_AsString(columns[i].bytes);
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    fill_node_table(ts_tree_root_node(tree), columns, count);
+    Py_END_ALLOW_THREADS
+
+    if (!(result = PyDict_New())) {
+        goto done;
+    }
+    for (int i = 0; i < COLUMN_COUNT; i++) {
+        PyObject *view = PyMemoryView_FromObject(columns[i].bytes);
+        PyObject *column = view ? PyObject_CallMethod(view, "cast", "s", columns[i].format) : NULL;
+        Py_XDECREF(view);
+        if (!column || PyDict_SetItemString(result, columns[i].name, column) < 0) {
+            Py_XDECREF(column);
+            Py_CLEAR(result);
+            goto done;
+        }
+        Py_DECREF(column);
+    }
+
+done:
+    for (int i = 0; i < COLUMN_COUNT; i++) {
+        Py_XDECREF(columns[i].bytes);
+    }
+    ts_tree_delete(tree);
+    return result;
+}
+
+static PyObject *_binding_symbol_names(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args)) {
+    const TSLanguage *language = tree_sitter_lean();
+    uint32_t count = ts_language_symbol_count(language);
+    PyObject *names = PyList_New(count);
+    for (uint32_t i = 0; names && i < count; i++) {
+        PyObject *name = PyUnicode_FromString(ts_language_symbol_name(language, (TSSymbol)i));
+        if (!name) {
+            Py_CLEAR(names);
+            break;
+        }
+        PyList_SetItem(names, i, name);
+    }
+    return names;
+}
+
+#endif
+
 static struct PyModuleDef_Slot slots[] = {
 #ifdef Py_GIL_DISABLED
     {Py_mod_gil, Py_MOD_GIL_NOT_USED},
@@ -18,6 +365,14 @@ static struct PyModuleDef_Slot slots[] = {
 static PyMethodDef methods[] = {
     {"language", _binding_language, METH_NOARGS,
      "Get the tree-sitter language for this grammar."},
+#ifdef TREE_SITTER_LEAN_RUNTIME
+    {"parse_many", (PyCFunction)(void (*)(void))_binding_parse_many, METH_VARARGS | METH_KEYWORDS,
+     "Parse files on native threads, without the GIL, and return their outlines."},
+    {"node_table", _binding_node_table, METH_O,
+     "Parse source and return its nodes as columns of memoryviews."},
+    {"symbol_names", _binding_symbol_names, METH_NOARGS,
+     "Get the node type of every symbol, indexed by kind id."},
+#endif
     {NULL, NULL, 0, NULL}
 };
 
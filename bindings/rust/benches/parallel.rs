@@ -0,0 +1,60 @@
+//! Multi-core scaling of `parse_files` over `bench/corpus`, from one thread
+//! up to the number of cores.
+//!
+//! cargo bench --features parallel --bench parallel
+
+use std::fs;
+use std::path::{Path, PathBuf};
+use std::thread;
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use rayon::ThreadPoolBuilder;
+
+fn corpus() -> Vec<PathBuf> {
+    // the files of bench/corpus/train and bench/corpus/eval
+    let dir = Path::new(env!("CARGO_MANIFEST_DIR")).join("bench/corpus");
+    let files: Vec<_> = fs::read_dir(dir)
+        .expect("missing bench/corpus")
+        .flat_map(|entry| fs::read_dir(entry.unwrap().path()).into_iter().flatten())
+        .map(|entry| entry.unwrap().path())
+        .filter(|path| {
+            path.extension()
+                .is_some_and(|extension| extension == "lean")
+        })
+        .collect();
+    // enough files to give every thread some work
+    files
+        .iter()
+        .cycle()
+        .take(files.len().max(64 * cores()))
+        .cloned()
+        .collect()
+}
+
+fn cores() -> usize {
+    thread::available_parallelism().map_or(1, |n| n.get())
+}
+
+fn scaling(c: &mut Criterion) {
+    let files = corpus();
+    let bytes: u64 = files
+        .iter()
+        .map(|path| fs::metadata(path).unwrap().len())
+        .sum();
+    let mut group = c.benchmark_group("parse_files");
+    group.throughput(Throughput::Bytes(bytes));
+    group.sample_size(10);
+    for threads in 1..=cores() {
+        let pool = ThreadPoolBuilder::new()
+            .num_threads(threads)
+            .build()
+            .unwrap();
+        group.bench_with_input(BenchmarkId::from_parameter(threads), &files, |b, files| {
+            b.iter(|| pool.install(|| tree_sitter_lean::parse_files(files.clone())))
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, scaling);
+criterion_main!(benches);
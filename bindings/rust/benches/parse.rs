@@ -0,0 +1,103 @@
+//! Single-file throughput and incremental reparsing over `bench/corpus`.
+//!
+//! cargo bench --bench parse
+
+use std::fs;
+use std::path::Path;
+
+use criterion::{criterion_group, criterion_main, BatchSize, Criterion, Throughput};
+use tree_sitter::{InputEdit, Parser, Point};
+
+fn corpus() -> Vec<(String, Vec<u8>)> {
+    // the files of bench/corpus/train and bench/corpus/eval
+    let root = Path::new(env!("CARGO_MANIFEST_DIR")).join("bench/corpus");
+    let mut files: Vec<_> = fs::read_dir(&root)
+        .expect("missing bench/corpus")
+        .flat_map(|entry| fs::read_dir(entry.unwrap().path()).into_iter().flatten())
+        .map(|entry| entry.unwrap().path())
+        .filter(|path| {
+            path.extension()
+                .is_some_and(|extension| extension == "lean")
+        })
+        .map(|path| {
+            let name = path.strip_prefix(&root).unwrap().to_string_lossy().into_owned();
+            (name, fs::read(&path).unwrap())
+        })
+        .collect();
+    files.sort();
+    files
+}
+
+fn parser() -> Parser {
+    let mut parser = Parser::new();
+    parser
+        .set_language(&tree_sitter_lean::LANGUAGE.into())
+        .expect("Error loading Lean parser");
+    parser
+}
+
+fn point_at(source: &[u8], byte: usize) -> Point {
+    let before = &source[..byte];
+    let row = before.iter().filter(|&&c| c == b'\n').count();
+    let column = byte
+        - before
+            .iter()
+            .rposition(|&c| c == b'\n')
+            .map_or(0, |i| i + 1);
+    Point { row, column }
+}
+
+fn single_file(c: &mut Criterion) {
+    let mut group = c.benchmark_group("parse");
+    let mut parser = parser();
+    for (name, source) in corpus() {
+        group.throughput(Throughput::Bytes(source.len() as u64));
+        group.bench_function(name, |b| b.iter(|| parser.parse(&source, None).unwrap()));
+    }
+    group.finish();
+}
+
+// Inserts a blank line at the start of the line closest to the middle of each
+// file and reparses it, as an editor would after a keystroke.
+fn incremental(c: &mut Criterion) {
+    let mut group = c.benchmark_group("reparse");
+    let mut parser = parser();
+    for (name, source) in corpus() {
+        let middle = source[..source.len() / 2]
+            .iter()
+            .rposition(|&c| c == b'\n')
+            .map_or(0, |i| i + 1);
+        let mut edited = source.clone();
+        edited.insert(middle, b'\n');
+        let start_position = point_at(&source, middle);
+        let edit = InputEdit {
+            start_byte: middle,
+            old_end_byte: middle,
+            new_end_byte: middle + 1,
+            start_position,
+            old_end_position: start_position,
+            new_end_position: Point {
+                row: start_position.row + 1,
+                column: 0,
+            },
+        };
+        let tree = parser.parse(&source, None).unwrap();
+
+        group.throughput(Throughput::Bytes(source.len() as u64));
+        group.bench_function(name, |b| {
+            b.iter_batched(
+                || {
+                    let mut old_tree = tree.clone();
+                    old_tree.edit(&edit);
+                    old_tree
+                },
+                |old_tree| parser.parse(&edited, Some(&old_tree)).unwrap(),
+                BatchSize::SmallInput,
+            )
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, single_file, incremental);
+criterion_main!(benches);
@@ -15,11 +15,19 @@
 //! assert!(!tree.root_node().has_error());
 //! ```
 //!
+//! With the `parallel` feature, [`parse_dir`] parses a whole directory tree on
+//! all cores and extracts the outline of every file.
+//!
 //! [`Parser`]: https://docs.rs/tree-sitter/0.25.5/tree_sitter/struct.Parser.html
 //! [tree-sitter]: https://tree-sitter.github.io/
 
 use tree_sitter_language::LanguageFn;
 
+#[cfg(feature = "parallel")]
+mod parallel;
+#[cfg(feature = "parallel")]
+pub use parallel::{command_node, outline, parse_dir, parse_files, OutlineItem, ParsedFile};
+
 extern "C" {
     fn tree_sitter_lean() -> *const ();
 }
@@ -35,7 +43,7 @@ pub const NODE_TYPES: &str = include_str!("../../src/node-types.json");
 // NOTE: uncomment these to include any queries that this grammar contains:
 
 // pub const HIGHLIGHTS_QUERY: &str = include_str!("../../queries/highlights.scm");
-// pub const INJECTIONS_QUERY: &str = include_str!("../../queries/injections.scm");
+pub const INJECTIONS_QUERY: &str = include_str!("../../queries/injections.scm");
 // pub const LOCALS_QUERY: &str = include_str!("../../queries/locals.scm");
 // pub const TAGS_QUERY: &str = include_str!("../../queries/tags.scm");
 
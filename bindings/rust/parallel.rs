@@ -0,0 +1,197 @@
+//! Parsing of whole directory trees on all cores, enabled by the `parallel`
+//! feature.
+
+use std::fs;
+use std::io;
+use std::ops::Range;
+use std::path::{Path, PathBuf};
+
+use rayon::prelude::*;
+use tree_sitter::{Node, Parser, Tree};
+
+/// An entry of a file's outline: a top-level declaration, namespace, section
+/// or syntax extension.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct OutlineItem {
+    /// The node type that best describes the entry, such as `theorem` rather
+    /// than `cmd_declaration`.
+    pub kind: &'static str,
+    /// The bytes of the entry's name, empty for anonymous entries such as
+    /// `example`.
+    pub name: Range<usize>,
+    /// The bytes of the whole command.
+    pub range: Range<usize>,
+}
+
+/// A file parsed by [`parse_dir`] or [`parse_files`].
+pub struct ParsedFile {
+    pub path: PathBuf,
+    pub source: Vec<u8>,
+    pub tree: Tree,
+    pub outline: Vec<OutlineItem>,
+}
+
+/// Commands other than declarations that belong in an outline.
+const OUTLINE_COMMANDS: &[&str] = &[
+    "cmd_namespace",
+    "cmd_section",
+    "cmd_noncomputable_section",
+    "cmd_initialize",
+    "cmd_mutual",
+    "cmd_mixfix",
+    "cmd_notation",
+    "cmd_syntax",
+    "cmd_macro_rules",
+];
+
+/// The first (or last) named child of `node`, ignoring comments.
+fn named_child(node: Node, last: bool) -> Option<Node> {
+    let mut cursor = node.walk();
+    let mut children = node
+        .named_children(&mut cursor)
+        .filter(|child| !child.is_extra());
+    if last {
+        children.last()
+    } else {
+        children.next()
+    }
+}
+
+/// The node describing a top-level `command`: the declaration itself for
+/// `cmd_declaration`, the trailing command for `cmd_in`, and the `cmd_*` node
+/// otherwise.
+pub fn command_node(command: Node) -> Option<Node> {
+    let cmd = named_child(command, false)?;
+    match cmd.kind() {
+        "cmd_in" => command_node(named_child(cmd, true)?),
+        "cmd_declaration" => named_child(cmd, true),
+        _ => Some(cmd),
+    }
+}
+
+/// The name of an outline entry is its first `decl_ident` (without universe
+/// parameters) or `ident` child.
+fn find_name(node: Node) -> Option<Node> {
+    let mut cursor = node.walk();
+    let mut children = node.named_children(&mut cursor);
+    children.find_map(|child| match child.kind() {
+        "decl_ident" => child.named_child(0),
+        "ident" => Some(child),
+        _ => None,
+    })
+}
+
+/// The outline of a parsed file, in source order.
+pub fn outline(tree: &Tree) -> Vec<OutlineItem> {
+    let root = tree.root_node();
+    let mut cursor = root.walk();
+    let items = root
+        .named_children(&mut cursor)
+        .filter(|command| command.kind() == "command")
+        .filter_map(|command| {
+            let node = command_node(command)?;
+            let kind = node.kind();
+            if kind.starts_with("cmd_") && !OUTLINE_COMMANDS.contains(&kind) {
+                return None;
+            }
+            let range = command.byte_range();
+            let name = find_name(node).map_or(range.start..range.start, |name| name.byte_range());
+            Some(OutlineItem { kind, name, range })
+        })
+        .collect();
+    items
+}
+
+fn new_parser() -> Parser {
+    let mut parser = Parser::new();
+    parser
+        .set_language(&crate::LANGUAGE.into())
+        .expect("Error loading Lean parser");
+    parser
+}
+
+fn parse_file(parser: &mut Parser, path: PathBuf) -> io::Result<ParsedFile> {
+    let source = fs::read(&path)
+        .map_err(|error| io::Error::new(error.kind(), format!("{}: {error}", path.display())))?;
+    let tree = parser
+        .parse(&source, None)
+        .ok_or_else(|| io::Error::other(format!("{}: parsing was cancelled", path.display())))?;
+    let outline = outline(&tree);
+    Ok(ParsedFile {
+        path,
+        source,
+        tree,
+        outline,
+    })
+}
+
+fn collect_files(dir: &Path, paths: &mut Vec<PathBuf>) -> io::Result<()> {
+    for entry in fs::read_dir(dir)? {
+        let path = entry?.path();
+        if path
+            .file_name()
+            .is_some_and(|name| name.as_encoded_bytes().starts_with(b"."))
+        {
+            continue;
+        }
+        if path.is_dir() {
+            collect_files(&path, paths)?;
+        } else if path
+            .extension()
+            .is_some_and(|extension| extension == "lean")
+        {
+            paths.push(path);
+        }
+    }
+    Ok(())
+}
+
+/// Parses `paths` on the current rayon thread pool, with one parser per
+/// thread. The results are in the same order as the paths, and a file that
+/// can't be read doesn't stop the others.
+pub fn parse_files(paths: Vec<PathBuf>) -> Vec<io::Result<ParsedFile>> {
+    paths
+        .into_par_iter()
+        .map_init(new_parser, parse_file)
+        .collect()
+}
+
+/// Parses every `.lean` file below `dir` with [`parse_files`], sorted by path.
+pub fn parse_dir(dir: impl AsRef<Path>) -> io::Result<Vec<io::Result<ParsedFile>>> {
+    let mut paths = Vec::new();
+    collect_files(dir.as_ref(), &mut paths)?;
+    paths.sort();
+    Ok(parse_files(paths))
+}
+
+#[cfg(test)]
+mod tests {
+    #[test]
+    fn test_parse_dir() {
+        let dir = std::env::temp_dir().join(format!("tree-sitter-lean-{}", std::process::id()));
+        std::fs::create_dir_all(dir.join("Foo")).unwrap();
+        std::fs::write(
+            dir.join("Foo/Bar.lean"),
+            "namespace Foo\ntheorem bar : True := trivial\nend Foo\n",
+        )
+        .unwrap();
+        std::fs::write(dir.join("notes.txt"), "not Lean").unwrap();
+
+        let files = super::parse_dir(&dir).unwrap();
+        std::fs::remove_dir_all(&dir).unwrap();
+        assert_eq!(files.len(), 1);
+        let file = files[0].as_ref().unwrap();
+        assert!(!file.tree.root_node().has_error());
+        let names: Vec<_> = file
+            .outline
+            .iter()
+            .map(|item| {
+                (
+                    item.kind,
+                    std::str::from_utf8(&file.source[item.name.clone()]).unwrap(),
+                )
+            })
+            .collect();
+        assert_eq!(names, [("cmd_namespace", "Foo"), ("theorem", "bar")]);
+    }
+}
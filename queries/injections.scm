@@ -0,0 +1,11 @@
+; Docstrings and module docs are Markdown. Fenced code blocks inside them are
+; handed back to this grammar by the Markdown grammar's own injections, which
+; resolve the fence's info string (```lean) through `injection-regex`.
+
+((documentation
+  (comment_body) @injection.content)
+  (#set! injection.language "markdown"))
+
+((cmd_module_doc
+  (comment_body) @injection.content)
+  (#set! injection.language "markdown"))
@@ -1,5 +1,7 @@
-from os import path
+from os import environ, path
 from platform import system
+from shutil import which
+from subprocess import run
 from sysconfig import get_config_var
 
 from setuptools import Extension, find_packages, setup
@@ -26,6 +28,44 @@ if system() != "Windows":
 else:
     cflags = ["/std:c11", "/utf-8"]
 
+include_dirs = ["src"]
+libraries: list[str] = []
+library_dirs: list[str] = []
+
+
+def find_runtime():
+    """Find the tree-sitter runtime that `parse_many` links against: a checkout
+    of tree-sitter's `lib` directory named by TREE_SITTER_LIB, which is compiled
+    into the extension, or an installed library found with pkg-config."""
+    if lib := environ.get("TREE_SITTER_LIB"):
+        sources.append(path.join(lib, "src", "lib.c"))
+        include_dirs.extend([path.join(lib, "include"), path.join(lib, "src")])
+        return True
+    if which("pkg-config") is None:
+        return False
+    result = run(["pkg-config", "--cflags-only-I", "--libs", "tree-sitter"],
+                 capture_output=True, text=True)
+    if result.returncode != 0:
+        return False
+    for flag in result.stdout.split():
+        if flag.startswith("-I"):
+            include_dirs.append(flag[2:])
+        elif flag.startswith("-L"):
+            library_dirs.append(flag[2:])
+        elif flag.startswith("-l"):
+            libraries.append(flag[2:])
+    return True
+
+
+# without a runtime the extension only provides `language()`
+if system() != "Windows" and find_runtime():
+    sources.extend([
+        "bindings/c/tree-sitter-lean-input.c",
+        "tools/outline.c",
+    ])
+    include_dirs.extend(["bindings/c", "tools"])
+    macros.append(("TREE_SITTER_LEAN_RUNTIME", None))
+
 
 class Build(build):
     def run(self):
@@ -48,6 +88,9 @@ class EggInfo(egg_info):
         super().find_sources()
         self.filelist.recursive_include("queries", "*.scm")
         self.filelist.include("src/tree_sitter/*.h")
+        self.filelist.include("bindings/c/tree-sitter-lean-input.c")
+        self.filelist.include("bindings/c/tree_sitter/tree-sitter-lean-input.h")
+        self.filelist.include("tools/outline.*")
 
 
 setup(
@@ -64,7 +107,9 @@ setup(
             sources=sources,
             extra_compile_args=cflags,
             define_macros=macros,
-            include_dirs=["src"],
+            include_dirs=include_dirs,
+            libraries=libraries,
+            library_dirs=library_dirs,
             py_limited_api=limited_api,
         )
     ],
@@ -51,6 +51,13 @@ typedef struct {
 // we use this to indicate parenthesis enclosures, simulating 'withoutPosition'
 #define CTX 0
 
+// how far past a '|' the '=>' of a match alternative is looked for. the bound
+// keeps a run of '|' without '=>' linear, at the price that an alternative
+// whose '=>' ends more than this many characters after its '|' (a very long
+// pattern, or a long comment before the '=>') is not recognized and parses as
+// an error. see the "match alternative" cases in test/corpus/scanner.txt
+#define MATCH_ALT_LOOKAHEAD 1024
+
 static inline void skip(TSLexer *lexer) { lexer->advance(lexer, true); }
 static inline void advance(TSLexer *lexer) { lexer->advance(lexer, false); }
 static inline bool eof(TSLexer *lexer) { return lexer->eof(lexer); }
@@ -60,6 +67,9 @@ static inline bool scan_raw_string_start(Scanner *scanner, TSLexer *lexer) {
 
   uint8_t opening_hash_count = 0;
   while (lexer->lookahead == '#') {
+    // the count has to fit in the serialized state
+    if (opening_hash_count == UINT8_MAX)
+      return false;
     advance(lexer);
     opening_hash_count++;
   }
@@ -109,9 +119,43 @@ static inline bool scan_raw_string_end(Scanner *scanner, TSLexer *lexer) {
   return true;
 }
 
+// Scans the body of a comment, docstring or module doc up to (not including)
+// the '-/' closing the outermost comment. Docstrings are mostly prose, so the
+// common case of a character that is neither '-' nor '/' is kept to a single
+// comparison, and eof is only queried once the lookahead reads as NUL.
+static inline bool scan_comment_body(TSLexer *lexer) {
+  uint32_t nesting = 0;
+  int32_t previous = 0;
+  for (;;) {
+    advance(lexer);
+    int32_t c = lexer->lookahead;
+    if (c != '-' && c != '/') {
+      if (c == 0 && eof(lexer))
+        return true;
+      previous = 0;
+    } else if (c == '/') {
+      if (previous == '-') {
+        if (!nesting)
+          return true;
+        nesting--;
+        previous = 0;
+      } else {
+        previous = '/';
+      }
+    } else if (previous == '/') {
+      nesting++;
+      previous = 0;
+    } else {
+      // this might be the '-' of the closing '-/'
+      previous = '-';
+      lexer->mark_end(lexer);
+    }
+  }
+}
+
 // Whether we are looking at a 'dedentable' character.
 // TODO: deal with ':' properly
-inline bool lookahead_dedent(TSLexer *lexer) {
+static inline bool lookahead_dedent(TSLexer *lexer) {
   return (lexer->lookahead == ')' || lexer->lookahead == ']' ||
           lexer->lookahead == '}' || lexer->lookahead == 10217 ||
           lexer->lookahead == ',' || lexer->lookahead == ':');
@@ -170,32 +214,7 @@ bool tree_sitter_lean_external_scanner_scan(void *payload, TSLexer *lexer,
 
   if (!exceptional && valid_symbols[COMMENT_BODY]) {
     lexer->result_symbol = COMMENT_BODY;
-    uint8_t nesting = 0;
-    char previous = false;
-    while (!eof(lexer)) {
-      advance(lexer);
-      if (lexer->lookahead == '/') {
-        if (previous == '-') {
-          if (!nesting)
-            return true;
-          nesting--;
-          previous = false;
-        } else {
-          previous = '/';
-        }
-      } else if (lexer->lookahead == '-') {
-        if (previous == '/') {
-          nesting++;
-          previous = false;
-        } else {
-          previous = '-';
-          lexer->mark_end(lexer);
-        }
-      } else {
-        previous = false;
-      }
-    }
-    return true;
+    return scan_comment_body(lexer);
   }
 
   // necessary for DEDENT, which must consume nothing
@@ -210,7 +229,9 @@ bool tree_sitter_lean_external_scanner_scan(void *payload, TSLexer *lexer,
     skip(lexer);
   }
 
-  uint8_t indent = lexer->get_column(lexer);
+  // columns are stored in a byte, anything further right is as good as 255
+  uint32_t column = lexer->get_column(lexer);
+  uint8_t indent = column < UINT8_MAX ? column : UINT8_MAX;
 
   lexer->log(lexer, "newline: %d", skipped_newline);
 
@@ -279,10 +300,15 @@ bool tree_sitter_lean_external_scanner_scan(void *payload, TSLexer *lexer,
     lexer->mark_end(lexer);
     skip(lexer);
 
-    // check for '=>' construct
+    // check for '=>' construct. the search stops at the next command (a line
+    // starting at column 0) and after MATCH_ALT_LOOKAHEAD characters, as each
+    // '|' of a long run without '=>' searches again from where it is.
     uint8_t state = 0;
-    for (;;) {
-      if (eof(lexer))
+    bool newline = false;
+    for (uint32_t n = 0;; n++) {
+      if (eof(lexer) || n == MATCH_ALT_LOOKAHEAD)
+        return false;
+      else if (newline && !iswspace(lexer->lookahead))
         return false;
       else if (lexer->lookahead == '=')
         state = 1;
@@ -291,6 +317,7 @@ bool tree_sitter_lean_external_scanner_scan(void *payload, TSLexer *lexer,
       else
         state = 0;
 
+      newline = lexer->lookahead == '\n';
       skip(lexer);
     }
 
@@ -334,7 +361,11 @@ unsigned tree_sitter_lean_external_scanner_serialize(void *payload,
   Scanner *scanner = (Scanner *)payload;
   size_t size = 0;
   buffer[size++] = scanner->opening_hash_count;
-  for (unsigned i = 0; i < scanner->cols.size; i++) {
+  // past this depth the innermost columns are dropped rather than written out
+  // of bounds
+  for (unsigned i = 0; i < scanner->cols.size &&
+                       size < TREE_SITTER_SERIALIZATION_BUFFER_SIZE;
+       i++) {
     buffer[size++] = *array_get(&scanner->cols, i);
   }
   return size;
@@ -345,6 +376,7 @@ void tree_sitter_lean_external_scanner_deserialize(void *payload,
                                                    unsigned length) {
   Scanner *scanner = (Scanner *)payload;
   array_delete(&scanner->cols);
+  scanner->opening_hash_count = 0;
   if (length > 0) {
     size_t size = 0;
     scanner->opening_hash_count = buffer[size++];
@@ -0,0 +1,406 @@
+// Attributes the memory allocated while parsing to the scanner and the parser,
+// per file and per top-level command.
+//
+// usage: tree-sitter-lean-allocs [-c commands] path...
+//
+// The grammar is compiled into this tool with TREE_SITTER_REUSE_ALLOCATOR, so
+// that the external scanner allocates through the runtime's ts_current_*
+// hooks, and ts_set_allocator points those at a counting allocator. Each
+// allocation is put in one of two categories:
+//
+//   scanner  made inside an external scanner call: the Scanner itself and its
+//            `cols` array, grown by `scan` and rebuilt by every `deserialize`
+//   parser   everything else: subtrees, the parse stack, the lexer, the tree
+//
+// For each file, a fresh parser parses it once. Reported per category are
+// the allocation count, the bytes allocated (a realloc counts its growth),
+// the peak live bytes during the parse, and the bytes still live once it
+// returns, which is mostly the tree. The scanner states serialized are
+// reported from the lengths `serialize` returns: the runtime stores states of
+// up to 24 bytes inline, and copies longer ones into allocations of their
+// own, counted under `parser`.
+//
+// Each allocation is also attributed to the top-level command at the byte
+// the lexer had reached, and the -c commands (default 5) that allocated the
+// most are listed, with the peak live bytes (of the whole parse) while they
+// were being parsed.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "files.h"
+#include "hooks.h"
+#include "outline.h"
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef TREE_SITTER_REUSE_ALLOCATOR
+#error "tree-sitter-lean-allocs must be built with TREE_SITTER_REUSE_ALLOCATOR"
+#endif
+
+enum { SCANNER, PARSER, CATEGORY_COUNT };
+
+static const char *const CATEGORY_NAMES[] = {"scanner", "parser"};
+
+// the size of the inline storage of the runtime's ExternalScannerState
+#define INLINE_STATE_SIZE 24
+
+typedef struct {
+  uint64_t allocs;
+  uint64_t bytes;
+  uint64_t live;
+  uint64_t peak;
+} Usage;
+
+// Allocations are counted while a file is being profiled, and attributed to
+// the byte the lexer last read. Events are kept in plain malloc'ed memory, as
+// array.h would allocate through the hooks being counted.
+typedef struct {
+  uint32_t offset;
+  uint32_t bytes;
+  uint8_t category;
+  // the live bytes of all categories right after the allocation
+  uint64_t live;
+} Event;
+
+typedef struct {
+  Usage usage[CATEGORY_COUNT];
+  uint64_t live;
+  uint64_t peak;
+  uint64_t serialized;
+  uint64_t serialized_bytes;
+  // states too long to be stored inline
+  uint64_t out_of_line;
+  uint64_t out_of_line_bytes;
+  Event *events;
+  size_t event_count;
+  size_t event_capacity;
+} Profile;
+
+// The hooks have no payload, so the state of the profiler is global.
+static Profile *profile;
+static uint32_t position;
+static bool in_scanner;
+
+// Every block starts with its size and category.
+typedef union {
+  struct {
+    size_t size;
+    uint8_t category;
+  } info;
+  max_align_t align;
+} Header;
+
+static void record(size_t size, uint8_t category) {
+  if (!profile)
+    return;
+  Usage *usage = &profile->usage[category];
+  usage->allocs++;
+  usage->bytes += size;
+  if ((usage->live += size) > usage->peak)
+    usage->peak = usage->live;
+  if ((profile->live += size) > profile->peak)
+    profile->peak = profile->live;
+
+  if (profile->event_count == profile->event_capacity) {
+    size_t capacity =
+        profile->event_capacity ? 2 * profile->event_capacity : 1024;
+    Event *events = realloc(profile->events, capacity * sizeof(Event));
+    if (!events)
+      return;
+    profile->events = events;
+    profile->event_capacity = capacity;
+  }
+  Event event = {position, size > UINT32_MAX ? UINT32_MAX : (uint32_t)size,
+                 category, profile->live};
+  profile->events[profile->event_count++] = event;
+}
+
+static void release(size_t size, uint8_t category) {
+  if (!profile)
+    return;
+  Usage *usage = &profile->usage[category];
+  usage->live = usage->live > size ? usage->live - size : 0;
+  profile->live = profile->live > size ? profile->live - size : 0;
+}
+
+static void *counting_malloc(size_t size) {
+  Header *header = malloc(sizeof(Header) + size);
+  if (!header)
+    return NULL;
+  header->info.size = size;
+  header->info.category = in_scanner ? SCANNER : PARSER;
+  record(size, header->info.category);
+  return header + 1;
+}
+
+static void *counting_calloc(size_t count, size_t size) {
+  if (size && count > (SIZE_MAX - sizeof(Header)) / size)
+    return NULL;
+  void *result = counting_malloc(count * size);
+  if (result)
+    memset(result, 0, count * size);
+  return result;
+}
+
+static void *counting_realloc(void *ptr, size_t size) {
+  if (!ptr)
+    return counting_malloc(size);
+  Header *header = (Header *)ptr - 1;
+  size_t old_size = header->info.size;
+  uint8_t category = header->info.category;
+  header = realloc(header, sizeof(Header) + size);
+  if (!header)
+    return NULL;
+  header->info.size = size;
+  if (size > old_size)
+    record(size - old_size, category);
+  else
+    release(old_size - size, category);
+  return header + 1;
+}
+
+static void counting_free(void *ptr) {
+  if (!ptr)
+    return;
+  Header *header = (Header *)ptr - 1;
+  release(header->info.size, header->info.category);
+  free(header);
+}
+
+// scanner hooks
+
+static void enter_scanner(void *payload, LeanScannerCall call) {
+  (void)payload;
+  (void)call;
+  in_scanner = true;
+}
+
+static void leave_scanner(void *payload, LeanScannerCall call,
+                          unsigned length) {
+  (void)payload;
+  in_scanner = false;
+  if (call != LEAN_SCANNER_SERIALIZE || !profile)
+    return;
+  profile->serialized++;
+  profile->serialized_bytes += length;
+  if (length > INLINE_STATE_SIZE) {
+    profile->out_of_line++;
+    profile->out_of_line_bytes += length;
+  }
+}
+
+// input
+
+typedef struct {
+  const char *text;
+  uint32_t length;
+} StringInput;
+
+// One character per read, so that `position` follows the lexer.
+static const char *read_character(void *payload, uint32_t byte_index,
+                                  TSPoint point, uint32_t *bytes_read) {
+  const StringInput *self = payload;
+  (void)point;
+  if (byte_index >= self->length) {
+    *bytes_read = 0;
+    return "";
+  }
+  unsigned char c = (unsigned char)self->text[byte_index];
+  uint32_t size = c < 0xc0 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+  if (size > self->length - byte_index)
+    size = self->length - byte_index;
+  position = byte_index;
+  *bytes_read = size;
+  return self->text + byte_index;
+}
+
+// report
+
+typedef struct {
+  TSNode node;
+  uint64_t allocs;
+  uint64_t bytes;
+  uint64_t scanner_bytes;
+  uint64_t peak;
+} Command;
+
+static int compare_commands(const void *a, const void *b) {
+  const Command *x = a, *y = b;
+  return x->bytes < y->bytes ? 1 : x->bytes > y->bytes ? -1 : 0;
+}
+
+static void print_usage_table(const Usage *usage, const Usage *after) {
+  Usage total = {0}, total_after = {0};
+  printf("  %-8s %10s %12s %12s %12s\n", "", "allocs", "bytes", "peak live",
+         "after parse");
+  for (int i = 0; i <= CATEGORY_COUNT; i++) {
+    const Usage *u = i < CATEGORY_COUNT ? &usage[i] : &total;
+    const Usage *a = i < CATEGORY_COUNT ? &after[i] : &total_after;
+    printf("  %-8s %10llu %12llu %12llu %12llu\n",
+           i < CATEGORY_COUNT ? CATEGORY_NAMES[i] : "total",
+           (unsigned long long)u->allocs, (unsigned long long)u->bytes,
+           (unsigned long long)u->peak, (unsigned long long)a->live);
+    if (i < CATEGORY_COUNT) {
+      total.allocs += u->allocs;
+      total.bytes += u->bytes;
+      total_after.live += a->live;
+    }
+  }
+}
+
+static void print_commands(TSTree *tree, const char *text,
+                           const Profile *file, unsigned limit) {
+  TSNode root = ts_tree_root_node(tree);
+  uint32_t count = ts_node_child_count(root);
+  Command *commands = calloc(count ? count : 1, sizeof(Command));
+  for (uint32_t i = 0; i < count; i++)
+    commands[i].node = ts_node_child(root, i);
+
+  // events are in offset order per parse, but error recovery can go back
+  for (size_t e = 0; e < file->event_count; e++) {
+    const Event *event = &file->events[e];
+    uint32_t low = 0, high = count;
+    while (low < high) {
+      uint32_t mid = low + (high - low) / 2;
+      if (ts_node_end_byte(commands[mid].node) <= event->offset)
+        low = mid + 1;
+      else
+        high = mid;
+    }
+    if (low == count ||
+        ts_node_start_byte(commands[low].node) > event->offset)
+      continue;
+    commands[low].allocs++;
+    commands[low].bytes += event->bytes;
+    if (event->category == SCANNER)
+      commands[low].scanner_bytes += event->bytes;
+    if (event->live > commands[low].peak)
+      commands[low].peak = event->live;
+  }
+
+  qsort(commands, count, sizeof(Command), compare_commands);
+  if (count > limit)
+    count = limit;
+  if (count > 0)
+    printf("  %-6s %-32s %10s %12s %12s %12s\n", "line", "command", "allocs",
+           "bytes", "scanner", "peak live");
+  LeanOutline outline = array_new();
+  lean_outline_collect(root, &outline);
+  for (uint32_t i = 0; i < count && commands[i].allocs > 0; i++) {
+    TSNode node = commands[i].node;
+    TSNode cmd = lean_command_node(node);
+    char label[64];
+    snprintf(label, sizeof(label), "%s",
+             ts_node_is_null(cmd) ? ts_node_type(node) : ts_node_type(cmd));
+    for (uint32_t j = 0; j < outline.size; j++) {
+      const LeanOutlineItem *item = &outline.contents[j];
+      uint32_t start = item->name.start_byte, end = item->name.end_byte;
+      if (item->range.start_byte == ts_node_start_byte(node) && end > start) {
+        snprintf(label, sizeof(label), "%s %.*s", item->kind,
+                 (int)(end - start < 40 ? end - start : 40), text + start);
+        break;
+      }
+    }
+    printf("  %-6u %-32s %10llu %12llu %12llu %12llu\n",
+           ts_node_start_point(node).row + 1, label,
+           (unsigned long long)commands[i].allocs,
+           (unsigned long long)commands[i].bytes,
+           (unsigned long long)commands[i].scanner_bytes,
+           (unsigned long long)commands[i].peak);
+  }
+  array_delete(&outline);
+  free(commands);
+}
+
+int main(int argc, char **argv) {
+  // before anything allocates through the hooks
+  ts_set_allocator(counting_malloc, counting_calloc, counting_realloc,
+                   counting_free);
+
+  unsigned limit = 5;
+  int first = 1;
+  for (; first + 1 < argc; first += 2) {
+    if (strcmp(argv[first], "-c") == 0)
+      limit = (unsigned)strtoul(argv[first + 1], NULL, 10);
+    else
+      break;
+  }
+  if (first >= argc) {
+    fprintf(stderr, "usage: %s [-c commands] path...\n", argv[0]);
+    return 2;
+  }
+
+  LeanPaths paths = array_new();
+  for (int i = first; i < argc; i++)
+    lean_collect_files(argv[i], &paths);
+
+  // the same language, with the external scanner wrapped for attribution
+  LeanScannerHooks hooks = {.enter = enter_scanner, .leave = leave_scanner};
+  const TSLanguage *profiled_language = lean_hooked_language(&hooks);
+
+  Usage totals[CATEGORY_COUNT] = {{0}}, totals_after[CATEGORY_COUNT] = {{0}};
+  uint64_t total_bytes = 0;
+  for (uint32_t f = 0; f < paths.size; f++) {
+    const char *path = paths.contents[f];
+    uint32_t length;
+    char *text = lean_read_file(path, &length);
+    if (!text) {
+      perror(path);
+      continue;
+    }
+
+    Profile file = {0};
+    // parser setup is attributed to no command
+    position = UINT32_MAX;
+    profile = &file;
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, profiled_language);
+    StringInput string = {text, length};
+    TSInput input = {.payload = &string,
+                     .read = read_character,
+                     .encoding = TSInputEncodingUTF8};
+    TSTree *tree = ts_parser_parse(parser, NULL, input);
+    Usage after[CATEGORY_COUNT];
+    memcpy(after, file.usage, sizeof(after));
+    profile = NULL;
+
+    printf("%s: %u bytes, peak live %llu, %llu states serialized (%llu "
+           "bytes), %llu out of line (%llu bytes)\n",
+           path, length, (unsigned long long)file.peak,
+           (unsigned long long)file.serialized,
+           (unsigned long long)file.serialized_bytes,
+           (unsigned long long)file.out_of_line,
+           (unsigned long long)file.out_of_line_bytes);
+    print_usage_table(file.usage, after);
+    if (tree && limit > 0)
+      print_commands(tree, text, &file, limit);
+
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+      totals[i].allocs += file.usage[i].allocs;
+      totals[i].bytes += file.usage[i].bytes;
+      if (file.usage[i].peak > totals[i].peak)
+        totals[i].peak = file.usage[i].peak;
+      totals_after[i].live += after[i].live;
+    }
+    total_bytes += length;
+
+    ts_tree_delete(tree);
+    ts_parser_delete(parser);
+    free(file.events);
+    free(text);
+  }
+
+  if (paths.size > 1) {
+    printf("total: %u files, %llu bytes (peaks are the largest of any file)\n",
+           paths.size, (unsigned long long)total_bytes);
+    print_usage_table(totals, totals_after);
+  }
+  lean_paths_delete(&paths);
+  return 0;
+}
@@ -0,0 +1,142 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "budget.h"
+#include "imports.h"
+
+#include <tree_sitter/tree-sitter-lean-input.h>
+
+#include <string.h>
+#include <time.h>
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+const char *lean_parse_mode_name(LeanParseMode mode) {
+  switch (mode) {
+  case LEAN_PARSE_FULL:
+    return "full";
+  case LEAN_PARSE_SKELETON:
+    return "skeleton";
+  case LEAN_PARSE_HEADER:
+    return "header";
+  case LEAN_PARSE_CANCELLED:
+    return "cancelled";
+  }
+  return "unknown";
+}
+
+typedef Array(TSRange) Ranges;
+
+typedef struct {
+  const LeanParseBudget *budget;
+  double deadline;
+  bool cancelled;
+} Deadline;
+
+// called by the parser every hundred or so operations
+static bool over_budget(TSParseState *state) {
+  Deadline *self = state->payload;
+  const volatile size_t *flag = self->budget->cancellation_flag;
+  if (flag && *flag) {
+    self->cancelled = true;
+    return true;
+  }
+  return self->deadline > 0 && now() > self->deadline;
+}
+
+static TSTree *parse(TSParser *parser, const char *source, uint32_t length,
+                     Deadline *deadline) {
+  TreeSitterLeanFile file = {source, length, NULL};
+  if (deadline->budget->time_micros)
+    deadline->deadline = now() + deadline->budget->time_micros / 1e6;
+  TSParseOptions options = {.payload = deadline,
+                            .progress_callback = over_budget};
+  TSTree *tree = ts_parser_parse_with_options(
+      parser, NULL, tree_sitter_lean_file_input(&file), options);
+  // a stopped parse would otherwise be resumed by the next one
+  if (!tree)
+    ts_parser_reset(parser);
+  return tree;
+}
+
+static TSPoint advance(const char *source, uint32_t from, TSPoint point,
+                       uint32_t to) {
+  const char *p = source + from, *end = source + to, *newline;
+  while ((newline = memchr(p, '\n', (size_t)(end - p)))) {
+    point.row++;
+    point.column = 0;
+    p = newline + 1;
+  }
+  point.column += (uint32_t)(end - p);
+  return point;
+}
+
+static void push_range(Ranges *ranges, const char *source,
+                       uint32_t start, uint32_t end, uint32_t *byte,
+                       TSPoint *point) {
+  TSRange range;
+  range.start_point = advance(source, *byte, *point, start);
+  range.end_point = advance(source, start, range.start_point, end);
+  range.start_byte = start;
+  range.end_byte = end;
+  array_push(ranges, range);
+  *byte = end;
+  *point = range.end_point;
+}
+
+// The header, then the first line of every command.
+static TSTree *parse_skeleton(TSParser *parser, const char *source,
+                              uint32_t length, Deadline *deadline) {
+  Ranges ranges = array_new();
+  uint32_t byte = 0;
+  TSPoint point = {0, 0};
+  uint32_t line = lean_header_end(source, length);
+  if (line > 0)
+    push_range(&ranges, source, 0, line, &byte, &point);
+  if (tree_sitter_lean_command_start(source, length, line) != line)
+    line = tree_sitter_lean_next_command_start(source, length, line);
+  while (line < length) {
+    const char *newline = memchr(source + line, '\n', length - line);
+    uint32_t end = newline ? (uint32_t)(newline - source) + 1 : length;
+    push_range(&ranges, source, line, end, &byte, &point);
+    // the ranges must increase, so a start that doesn't move on ends them
+    uint32_t next = tree_sitter_lean_next_command_start(source, length, line);
+    if (next <= line)
+      break;
+    line = next;
+  }
+
+  TSTree *tree = NULL;
+  if (ranges.size > 0) {
+    ts_parser_set_included_ranges(parser, ranges.contents, ranges.size);
+    tree = parse(parser, source, length, deadline);
+    ts_parser_set_included_ranges(parser, NULL, 0);
+  }
+  array_delete(&ranges);
+  return tree;
+}
+
+TSTree *lean_parse_with_budget(TSParser *parser, const char *source,
+                               uint32_t length, const LeanParseBudget *budget,
+                               LeanParseMode *mode) {
+  Deadline deadline = {budget, 0, false};
+  TSTree *tree = NULL;
+  if (!budget->bytes || length <= budget->bytes) {
+    *mode = LEAN_PARSE_FULL;
+    tree = parse(parser, source, length, &deadline);
+  }
+  if (!tree && !deadline.cancelled) {
+    *mode = LEAN_PARSE_SKELETON;
+    tree = parse_skeleton(parser, source, length, &deadline);
+  }
+  if (!tree && !deadline.cancelled) {
+    *mode = LEAN_PARSE_HEADER;
+    tree = lean_header_parse(parser, source, length);
+  }
+  if (!tree)
+    *mode = LEAN_PARSE_CANCELLED;
+  return tree;
+}
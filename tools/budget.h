@@ -0,0 +1,48 @@
+#ifndef TREE_SITTER_LEAN_BUDGET_H_
+#define TREE_SITTER_LEAN_BUDGET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Limits on the parse of one file, each 0 for none.
+typedef struct {
+  uint64_t time_micros;
+  // larger files skip the full parse only: they still get a skeleton parse,
+  // which scans the whole file for command starts
+  uint32_t bytes;
+  // the parse is abandoned, without a fallback, once this is nonzero; as with
+  // ts_parser_set_cancellation_flag, it may be set from another thread
+  const volatile size_t *cancellation_flag;
+} LeanParseBudget;
+
+typedef enum {
+  LEAN_PARSE_FULL,
+  // the first line of every command and the header: enough for the outline
+  // of most files, with the rest of each command missing
+  LEAN_PARSE_SKELETON,
+  // the header only
+  LEAN_PARSE_HEADER,
+  LEAN_PARSE_CANCELLED,
+} LeanParseMode;
+
+const char *lean_parse_mode_name(LeanParseMode mode);
+
+// Parses `source` in full within `budget`, falling back to a skeleton parse
+// (given the time budget afresh), and then to a header parse (not limited,
+// but small) when that runs out too. The mode of the returned tree is stored
+// in `mode`. Returns NULL only when cancelled.
+TSTree *lean_parse_with_budget(TSParser *parser, const char *source,
+                               uint32_t length, const LeanParseBudget *budget,
+                               LeanParseMode *mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_LEAN_BUDGET_H_
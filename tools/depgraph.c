@@ -0,0 +1,181 @@
+// Builds the import graph of a Lean project and parses it in dependency order.
+//
+// usage: tree-sitter-lean-depgraph [-j threads] [-m mode] [-t ms] [-b bytes]
+//                                   root
+//
+// Only the headers of the `.lean` files below `root` are parsed to find their
+// imports; module names are paths relative to `root` (`A/B.lean` is `A.B`).
+// Modules are then grouped in waves: those importing nothing from the project
+// first, then those importing only modules of earlier waves, and so on. Mode:
+//
+//   waves  the size of every wave (the default)
+//   order  one `wave<TAB>module<TAB>path` line per module, in schedule order
+//   parse  parses every module in full, a wave at a time across the threads,
+//          and reports the time taken, as a cross-file indexer would
+//
+// Threads default to one per CPU. In parse mode, -t and -b set a budget per
+// file: a parse taking longer than `ms` milliseconds, or of a file larger than
+// `bytes`, falls back to a skeleton or header parse (see budget.h), so that a
+// single pathological file can't stall a worker. Files over budget are listed
+// at the end with the mode they were parsed in. Files that couldn't be read are
+// listed too, and make the exit status 1.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "budget.h"
+#include "imports.h"
+
+#include <tree_sitter/tree-sitter-lean-input.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef struct {
+  const LeanImportGraph *graph;
+  TSParser **parsers;
+  LeanParseBudget budget;
+  // the mode each module was parsed in, unless it couldn't be read
+  LeanParseMode *modes;
+  bool *unreadable;
+  atomic_uint_least64_t bytes;
+  atomic_uint_least64_t nodes;
+} Parse;
+
+static void parse_module(void *payload, uint32_t index, unsigned worker) {
+  Parse *self = payload;
+  const char *path = self->graph->modules.contents[index].path;
+  TreeSitterLeanFile file;
+  if (tree_sitter_lean_file_open(&file, path) != 0) {
+    perror(path);
+    self->unreadable[index] = true;
+    return;
+  }
+  TSTree *tree =
+      lean_parse_with_budget(self->parsers[worker], file.data,
+                             (uint32_t)file.length, &self->budget,
+                             &self->modes[index]);
+  atomic_fetch_add(&self->bytes, file.length);
+  if (tree)
+    atomic_fetch_add(&self->nodes,
+                     ts_node_descendant_count(ts_tree_root_node(tree)));
+  ts_tree_delete(tree);
+  tree_sitter_lean_file_close(&file);
+}
+
+int main(int argc, char **argv) {
+  unsigned threads = 0;
+  const char *mode = "waves";
+  LeanParseBudget budget = {0};
+  int first = 1, status = 0;
+  for (; first + 1 < argc; first += 2) {
+    if (strcmp(argv[first], "-j") == 0)
+      threads = (unsigned)strtoul(argv[first + 1], NULL, 10);
+    else if (strcmp(argv[first], "-m") == 0)
+      mode = argv[first + 1];
+    else if (strcmp(argv[first], "-t") == 0)
+      budget.time_micros = strtoull(argv[first + 1], NULL, 10) * 1000;
+    else if (strcmp(argv[first], "-b") == 0)
+      budget.bytes = (uint32_t)strtoul(argv[first + 1], NULL, 10);
+    else
+      break;
+  }
+  if (first + 1 != argc || (strcmp(mode, "waves") != 0 &&
+                            strcmp(mode, "order") != 0 &&
+                            strcmp(mode, "parse") != 0)) {
+    fprintf(stderr,
+            "usage: %s [-j threads] [-m waves|order|parse] [-t ms] "
+            "[-b bytes] root\n",
+            argv[0]);
+    return 2;
+  }
+  if (threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cpus > 0 ? (unsigned)cpus : 1;
+  }
+
+  LeanPaths paths = array_new();
+  lean_collect_files(argv[first], &paths);
+  double scan_time = now();
+  LeanImportGraph graph;
+  lean_import_graph_build(&graph, &paths, argv[first], threads);
+  scan_time = now() - scan_time;
+  lean_paths_delete(&paths);
+
+  uint64_t imports = 0;
+  for (uint32_t i = 0; i < graph.modules.size; i++)
+    imports += graph.modules.contents[i].imports.size;
+  fprintf(stderr,
+          "%u modules, %llu imports (%u outside the project), %u waves, "
+          "%u modules in import cycles; headers scanned in %.1f ms\n",
+          graph.modules.size, (unsigned long long)imports,
+          graph.external_imports, graph.waves.size, graph.cyclic,
+          scan_time * 1e3);
+
+  if (strcmp(mode, "waves") == 0) {
+    for (uint32_t w = 0, start = 0; w < graph.waves.size; w++) {
+      printf("wave %u: %u modules\n", w, graph.waves.contents[w] - start);
+      start = graph.waves.contents[w];
+    }
+  } else if (strcmp(mode, "order") == 0) {
+    for (uint32_t i = 0; i < graph.order.size; i++) {
+      const LeanModule *module =
+          &graph.modules.contents[graph.order.contents[i]];
+      printf("%u\t%s\t%s\n", module->wave, module->name, module->path);
+    }
+  } else {
+    Parse parse = {
+        .graph = &graph,
+        .parsers = malloc(threads * sizeof(TSParser *)),
+        .budget = budget,
+        .modes = calloc(graph.modules.size, sizeof(LeanParseMode)),
+        .unreadable = calloc(graph.modules.size, sizeof(bool)),
+    };
+    atomic_init(&parse.bytes, 0);
+    atomic_init(&parse.nodes, 0);
+    for (unsigned i = 0; i < threads; i++) {
+      parse.parsers[i] = ts_parser_new();
+      ts_parser_set_language(parse.parsers[i], tree_sitter_lean());
+    }
+    double parse_time = now();
+    lean_import_graph_run(&graph, threads, parse_module, &parse);
+    parse_time = now() - parse_time;
+    uint64_t bytes = atomic_load(&parse.bytes);
+    uint32_t unreadable = 0;
+    for (uint32_t i = 0; i < graph.order.size; i++)
+      unreadable += parse.unreadable[graph.order.contents[i]];
+    printf("parsed %u modules (%.1f MB, %llu nodes) in %u waves on %u "
+           "threads: %.1f ms, %.1f MB/s\n",
+           graph.order.size - unreadable, bytes / 1e6,
+           (unsigned long long)atomic_load(&parse.nodes), graph.waves.size,
+           threads, parse_time * 1e3, bytes / parse_time / 1e6);
+    for (uint32_t i = 0; i < graph.order.size; i++) {
+      uint32_t index = graph.order.contents[i];
+      if (parse.unreadable[index])
+        printf("unreadable: %s\n", graph.modules.contents[index].path);
+      else if (parse.modes[index] != LEAN_PARSE_FULL)
+        printf("over budget: %s (%s parse)\n",
+               graph.modules.contents[index].path,
+               lean_parse_mode_name(parse.modes[index]));
+    }
+    free(parse.modes);
+    free(parse.unreadable);
+    for (unsigned i = 0; i < threads; i++)
+      ts_parser_delete(parse.parsers[i]);
+    free(parse.parsers);
+    status = unreadable > 0;
+  }
+
+  lean_import_graph_delete(&graph);
+  return status;
+}
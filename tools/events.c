@@ -0,0 +1,234 @@
+#include "events.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// walker
+
+enum { ENTER, LEAVE, DONE };
+
+void lean_event_walker_init(LeanEventWalker *self, TSNode root,
+                            bool named_only) {
+  self->cursor = ts_tree_cursor_new(root);
+  self->named_only = named_only;
+  self->state = ENTER;
+  self->has_pending = false;
+}
+
+bool lean_event_walker_next(LeanEventWalker *self, LeanEvent *event) {
+  while (self->state != DONE) {
+    TSNode node = ts_tree_cursor_current_node(&self->cursor);
+    // the field is that of the cursor's node, so it is read before moving
+    TSFieldId field = ts_tree_cursor_current_field_id(&self->cursor);
+    bool leave = self->state == LEAVE;
+    if (!leave) {
+      if (!ts_tree_cursor_goto_first_child(&self->cursor))
+        self->state = LEAVE;
+    } else if (ts_tree_cursor_goto_next_sibling(&self->cursor)) {
+      self->state = ENTER;
+    } else if (!ts_tree_cursor_goto_parent(&self->cursor)) {
+      self->state = DONE;
+    }
+
+    bool named = ts_node_is_named(node);
+    if (named || !self->named_only) {
+      *event = (LeanEvent){
+          .leave = leave,
+          .named = named,
+          .symbol = ts_node_symbol(node),
+          .field = field,
+          .start_byte = ts_node_start_byte(node),
+          .end_byte = ts_node_end_byte(node),
+      };
+      return true;
+    }
+  }
+  return false;
+}
+
+void lean_event_walker_delete(LeanEventWalker *self) {
+  ts_tree_cursor_delete(&self->cursor);
+}
+
+bool lean_events_walk(TSNode root, bool named_only,
+                      bool (*callback)(void *payload, const LeanEvent *event),
+                      void *payload) {
+  LeanEventWalker walker;
+  lean_event_walker_init(&walker, root, named_only);
+  LeanEvent event;
+  bool completed = true;
+  while (lean_event_walker_next(&walker, &event)) {
+    if (!callback(payload, &event)) {
+      completed = false;
+      break;
+    }
+  }
+  lean_event_walker_delete(&walker);
+  return completed;
+}
+
+// encoding
+
+static uint32_t put_varint(uint8_t *out, uint64_t value) {
+  uint32_t size = 0;
+  while (value >= 0x80) {
+    out[size++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  out[size++] = (uint8_t)value;
+  return size;
+}
+
+// Returns the number of bytes read, 0 if `data` ends first, or -1 if the
+// varint runs past the 10 bytes a uint64_t takes.
+static int get_varint(const uint8_t *data, size_t size, uint64_t *value) {
+  *value = 0;
+  for (int i = 0; (size_t)i < size && i < 10; i++) {
+    *value |= (uint64_t)(data[i] & 0x7f) << (7 * i);
+    if (!(data[i] & 0x80))
+      return i + 1;
+  }
+  return size < 10 ? 0 : -1;
+}
+
+static uint64_t zigzag(int64_t value) {
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static uint32_t encode(const LeanEvent *event, uint32_t *last_start,
+                       uint8_t *out) {
+  if (event->leave) {
+    out[0] = 0;
+    return 1;
+  }
+  uint32_t size = 1;
+  out[0] = 1 | (event->named ? 2 : 0) | (event->field ? 4 : 0);
+  size += put_varint(out + size, event->symbol);
+  if (event->field)
+    size += put_varint(out + size, event->field);
+  size += put_varint(out + size,
+                     zigzag((int64_t)event->start_byte - *last_start));
+  size += put_varint(out + size, event->end_byte - event->start_byte);
+  *last_start = event->start_byte;
+  return size;
+}
+
+// ring buffer
+
+void lean_event_ring_init(LeanEventRing *self, uint32_t capacity) {
+  if (capacity < LEAN_EVENT_MAX_SIZE)
+    capacity = LEAN_EVENT_MAX_SIZE;
+  self->data = malloc(capacity);
+  self->capacity = self->data ? capacity : 0;
+  self->head = 0;
+  self->size = 0;
+  self->last_start = 0;
+}
+
+bool lean_event_ring_push(LeanEventRing *self, const LeanEvent *event) {
+  if (self->capacity - self->size < LEAN_EVENT_MAX_SIZE)
+    return false;
+  uint8_t record[LEAN_EVENT_MAX_SIZE];
+  uint32_t size = encode(event, &self->last_start, record);
+  uint32_t tail = (self->head + self->size) % self->capacity;
+  uint32_t first = self->capacity - tail < size ? self->capacity - tail : size;
+  memcpy(self->data + tail, record, first);
+  memcpy(self->data, record + first, size - first);
+  self->size += size;
+  return true;
+}
+
+uint32_t lean_event_ring_read(LeanEventRing *self, void *buffer,
+                              uint32_t size) {
+  if (size > self->size)
+    size = self->size;
+  uint32_t first =
+      self->capacity - self->head < size ? self->capacity - self->head : size;
+  memcpy(buffer, self->data + self->head, first);
+  memcpy((uint8_t *)buffer + first, self->data, size - first);
+  self->head = (self->head + size) % (self->capacity ? self->capacity : 1);
+  self->size -= size;
+  return size;
+}
+
+void lean_event_ring_delete(LeanEventRing *self) {
+  free(self->data);
+  self->data = NULL;
+  self->capacity = self->head = self->size = 0;
+}
+
+bool lean_event_walker_fill(LeanEventWalker *self, LeanEventRing *ring) {
+  for (;;) {
+    if (!self->has_pending &&
+        !(self->has_pending = lean_event_walker_next(self, &self->pending)))
+      return false;
+    if (!lean_event_ring_push(ring, &self->pending))
+      return true;
+    self->has_pending = false;
+  }
+}
+
+// decoding
+
+void lean_event_decoder_init(LeanEventDecoder *self) {
+  array_init(&self->open);
+  self->last_start = 0;
+}
+
+int lean_event_decode(LeanEventDecoder *self, const uint8_t *data,
+                      size_t size, LeanEvent *event) {
+  if (size == 0)
+    return 0;
+  if (data[0] == 0) {
+    if (self->open.size == 0)
+      return -1;
+    *event = *array_back(&self->open);
+    event->leave = true;
+    self->open.size--;
+    return 1;
+  }
+  // enter events have bit 0 set, only bits 1 and 2 may be set with it
+  if ((data[0] & ~7) || !(data[0] & 1))
+    return -1;
+
+  uint64_t symbol, field = 0, delta, length;
+  int offset = 1, n;
+  if ((n = get_varint(data + offset, size - offset, &symbol)) <= 0)
+    return n;
+  offset += n;
+  if (data[0] & 4) {
+    if ((n = get_varint(data + offset, size - offset, &field)) <= 0)
+      return n;
+    offset += n;
+  }
+  if ((n = get_varint(data + offset, size - offset, &delta)) <= 0)
+    return n;
+  offset += n;
+  if ((n = get_varint(data + offset, size - offset, &length)) <= 0)
+    return n;
+  offset += n;
+
+  int64_t start = (int64_t)self->last_start + unzigzag(delta);
+  if (symbol > UINT16_MAX || field > UINT16_MAX || start < 0 ||
+      (uint64_t)start + length > UINT32_MAX)
+    return -1;
+  *event = (LeanEvent){
+      .leave = false,
+      .named = data[0] & 2,
+      .symbol = (TSSymbol)symbol,
+      .field = (TSFieldId)field,
+      .start_byte = (uint32_t)start,
+      .end_byte = (uint32_t)(start + length),
+  };
+  self->last_start = (uint32_t)start;
+  array_push(&self->open, *event);
+  return offset;
+}
+
+void lean_event_decoder_delete(LeanEventDecoder *self) {
+  array_delete(&self->open);
+}
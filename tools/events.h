@@ -0,0 +1,102 @@
+#ifndef TREE_SITTER_LEAN_EVENTS_H_
+#define TREE_SITTER_LEAN_EVENTS_H_
+
+#include "tree_sitter/array.h"
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A node being entered or left, in document order. `symbol` is the node's
+// type (ts_node_symbol, named by ts_language_symbol_name as in
+// node-types.json) and `field` the field it is in its parent, or 0.
+typedef struct {
+  bool leave;
+  bool named;
+  TSSymbol symbol;
+  TSFieldId field;
+  uint32_t start_byte;
+  uint32_t end_byte;
+} LeanEvent;
+
+// A resumable walk of a tree, in memory proportional to its depth only.
+typedef struct {
+  TSTreeCursor cursor;
+  bool named_only;
+  uint8_t state;
+  // an event that didn't fit in a ring buffer, emitted first on the next fill
+  bool has_pending;
+  LeanEvent pending;
+} LeanEventWalker;
+
+// Starts a walk of `root` and its descendants. With `named_only`, anonymous
+// nodes (punctuation and keywords) get no events.
+void lean_event_walker_init(LeanEventWalker *self, TSNode root,
+                            bool named_only);
+
+// The next event, or false at the end of the walk.
+bool lean_event_walker_next(LeanEventWalker *self, LeanEvent *event);
+
+void lean_event_walker_delete(LeanEventWalker *self);
+
+// Calls `callback` for every event of the walk of `root` until it returns
+// false. Returns whether the walk was completed.
+bool lean_events_walk(TSNode root, bool named_only,
+                      bool (*callback)(void *payload, const LeanEvent *event),
+                      void *payload);
+
+// A bounded buffer of events in a compact binary encoding. An enter event is
+// a flags byte (bit 0 set, bit 1 when named, bit 2 when a field follows),
+// then varints: the symbol, the field if any, the start byte as a zigzag
+// encoded delta from the previous enter's, and the length. A leave event is a
+// single 0 byte, its node being the innermost one entered and not yet left.
+typedef struct {
+  uint8_t *data;
+  uint32_t capacity;
+  uint32_t head;
+  uint32_t size;
+  uint32_t last_start;
+} LeanEventRing;
+
+// The largest encoded event.
+#define LEAN_EVENT_MAX_SIZE 17
+
+void lean_event_ring_init(LeanEventRing *self, uint32_t capacity);
+
+// Appends an event, or returns false if it doesn't fit.
+bool lean_event_ring_push(LeanEventRing *self, const LeanEvent *event);
+
+// Moves up to `size` bytes of encoded events out of the ring.
+uint32_t lean_event_ring_read(LeanEventRing *self, void *buffer,
+                              uint32_t size);
+
+void lean_event_ring_delete(LeanEventRing *self);
+
+// Pushes the next events of a walk into `ring` until it is full. Returns
+// whether events remain, in which case the ring should be drained and this
+// called again.
+bool lean_event_walker_fill(LeanEventWalker *self, LeanEventRing *ring);
+
+// The state needed to decode a stream of events: the nodes entered and not
+// yet left.
+typedef struct {
+  Array(LeanEvent) open;
+  uint32_t last_start;
+} LeanEventDecoder;
+
+void lean_event_decoder_init(LeanEventDecoder *self);
+
+// Decodes one event from `data`, returning the number of bytes it took, or 0
+// if `data` ends within it. Returns -1 on malformed input.
+int lean_event_decode(LeanEventDecoder *self, const uint8_t *data,
+                      size_t size, LeanEvent *event);
+
+void lean_event_decoder_delete(LeanEventDecoder *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_LEAN_EVENTS_H_
@@ -0,0 +1,216 @@
+// Streams the syntax tree of a file as binary enter/leave events.
+//
+// usage: tree-sitter-lean-export [-k named|all] [-o output] path
+//        tree-sitter-lean-export -d stream
+//
+// The tree is walked with a single cursor into a 64 KiB ring buffer (see
+// events.h), which is drained to `output` (default stdout) whenever it fills
+// up, so memory use beyond the tree itself stays flat however large the file.
+// With `-k named` (the default), anonymous nodes are left out.
+//
+// The stream starts with the magic `LEANEV01`, then the symbol names and the
+// field names as a varint count followed by as many NUL-terminated strings
+// (fields are numbered from 1), then the events. `-d` prints a stream back as
+// text, one indented line per node.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "events.h"
+
+#include <tree_sitter/tree-sitter-lean-input.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAGIC "LEANEV01"
+#define BUFFER_SIZE 65536
+
+static void write_varint(FILE *out, uint32_t value) {
+  while (value >= 0x80) {
+    fputc((int)(value & 0x7f) | 0x80, out);
+    value >>= 7;
+  }
+  fputc((int)value, out);
+}
+
+static int export_file(const char *path, bool named_only, FILE *out) {
+  TSParser *parser = ts_parser_new();
+  const TSLanguage *language = tree_sitter_lean();
+  ts_parser_set_language(parser, language);
+  TSTree *tree = tree_sitter_lean_parse_file(parser, path, NULL);
+  ts_parser_delete(parser);
+  if (!tree) {
+    perror(path);
+    return 1;
+  }
+
+  fwrite(MAGIC, 1, 8, out);
+  uint32_t symbol_count = ts_language_symbol_count(language);
+  write_varint(out, symbol_count);
+  for (uint32_t i = 0; i < symbol_count; i++) {
+    const char *name = ts_language_symbol_name(language, (TSSymbol)i);
+    fwrite(name ? name : "", 1, name ? strlen(name) + 1 : 1, out);
+  }
+  uint32_t field_count = ts_language_field_count(language);
+  write_varint(out, field_count);
+  for (uint32_t i = 1; i <= field_count; i++) {
+    const char *name = ts_language_field_name_for_id(language, (TSFieldId)i);
+    fwrite(name ? name : "", 1, name ? strlen(name) + 1 : 1, out);
+  }
+
+  LeanEventWalker walker;
+  LeanEventRing ring;
+  lean_event_walker_init(&walker, ts_tree_root_node(tree), named_only);
+  lean_event_ring_init(&ring, BUFFER_SIZE);
+  char *buffer = malloc(BUFFER_SIZE);
+  uint64_t written = 0;
+  bool more;
+  do {
+    more = lean_event_walker_fill(&walker, &ring);
+    uint32_t size = lean_event_ring_read(&ring, buffer, BUFFER_SIZE);
+    fwrite(buffer, 1, size, out);
+    written += size;
+  } while (more);
+  free(buffer);
+  lean_event_ring_delete(&ring);
+  lean_event_walker_delete(&walker);
+  ts_tree_delete(tree);
+
+  fprintf(stderr, "%s: %llu bytes of events\n", path,
+          (unsigned long long)written);
+  return ferror(out) ? 1 : 0;
+}
+
+// decoding
+
+typedef Array(char *) Names;
+
+static bool read_names(FILE *in, Names *names) {
+  uint32_t count = 0;
+  for (int shift = 0, c;; shift += 7) {
+    if ((c = fgetc(in)) == EOF || shift > 28)
+      return false;
+    count |= (uint32_t)(c & 0x7f) << shift;
+    if (!(c & 0x80))
+      break;
+  }
+  Array(char) name = array_new();
+  for (uint32_t i = 0; i < count; i++) {
+    int c;
+    array_clear(&name);
+    while ((c = fgetc(in)) != EOF && c != '\0')
+      array_push(&name, (char)c);
+    if (c == EOF) {
+      array_delete(&name);
+      return false;
+    }
+    array_push(&name, '\0');
+    array_push(names, strdup(name.contents));
+  }
+  array_delete(&name);
+  return true;
+}
+
+static void delete_names(Names *names) {
+  for (uint32_t i = 0; i < names->size; i++)
+    free(names->contents[i]);
+  array_delete(names);
+}
+
+static int print_stream(const char *path) {
+  FILE *in = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+  if (!in) {
+    perror(path);
+    return 1;
+  }
+  char magic[8];
+  Names symbols = array_new(), fields = array_new();
+  int status = 0;
+  if (fread(magic, 1, 8, in) != 8 || memcmp(magic, MAGIC, 8) != 0 ||
+      !read_names(in, &symbols) || !read_names(in, &fields)) {
+    fprintf(stderr, "%s: not an event stream\n", path);
+    status = 1;
+    goto done;
+  }
+
+  LeanEventDecoder decoder;
+  lean_event_decoder_init(&decoder);
+  uint8_t *buffer = malloc(BUFFER_SIZE);
+  size_t size = 0, read;
+  while ((read = fread(buffer + size, 1, BUFFER_SIZE - size, in)) > 0 ||
+         size > 0) {
+    size += read;
+    size_t offset = 0;
+    LeanEvent event;
+    int n;
+    while ((n = lean_event_decode(&decoder, buffer + offset, size - offset,
+                                  &event)) > 0) {
+      offset += (size_t)n;
+      if (event.leave)
+        continue;
+      const char *type = event.symbol < symbols.size
+                             ? symbols.contents[event.symbol]
+                             : "?";
+      printf("%*s", 2 * (int)(decoder.open.size - 1), "");
+      if (event.field && event.field <= fields.size)
+        printf("%s: ", fields.contents[event.field - 1]);
+      printf(event.named ? "%s" : "\"%s\"", type);
+      printf(" [%u, %u)\n", event.start_byte, event.end_byte);
+    }
+    if (n < 0 || (read == 0 && offset < size)) {
+      fprintf(stderr, "%s: malformed event stream\n", path);
+      status = 1;
+      break;
+    }
+    memmove(buffer, buffer + offset, size - offset);
+    size -= offset;
+  }
+  free(buffer);
+  lean_event_decoder_delete(&decoder);
+
+done:
+  delete_names(&symbols);
+  delete_names(&fields);
+  if (in != stdin)
+    fclose(in);
+  return status;
+}
+
+int main(int argc, char **argv) {
+  bool named_only = true;
+  const char *output = NULL, *decode = NULL;
+  int first = 1;
+  for (; first + 1 < argc; first += 2) {
+    if (strcmp(argv[first], "-k") == 0 &&
+        (strcmp(argv[first + 1], "named") == 0 ||
+         strcmp(argv[first + 1], "all") == 0))
+      named_only = strcmp(argv[first + 1], "named") == 0;
+    else if (strcmp(argv[first], "-o") == 0)
+      output = argv[first + 1];
+    else if (strcmp(argv[first], "-d") == 0)
+      decode = argv[first + 1];
+    else
+      break;
+  }
+  if (decode && first == argc)
+    return print_stream(decode);
+  if (decode || first + 1 != argc) {
+    fprintf(stderr,
+            "usage: %s [-k named|all] [-o output] path\n"
+            "       %s -d stream\n",
+            argv[0], argv[0]);
+    return 2;
+  }
+
+  FILE *out = output ? fopen(output, "wb") : stdout;
+  if (!out) {
+    perror(output);
+    return 1;
+  }
+  int status = export_file(argv[first], named_only, out);
+  if (out != stdout && fclose(out) != 0)
+    status = 1;
+  return status;
+}
@@ -0,0 +1,76 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "files.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+char *lean_read_file(const char *path, uint32_t *length) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return NULL;
+  char *buffer = NULL;
+  if (fseek(f, 0, SEEK_END) == 0) {
+    long size = ftell(f);
+    if (size >= 0 && size <= UINT32_MAX && fseek(f, 0, SEEK_SET) == 0 &&
+        (buffer = malloc((size_t)size + 1))) {
+      if (fread(buffer, 1, (size_t)size, f) == (size_t)size) {
+        buffer[size] = '\0';
+        *length = (uint32_t)size;
+      } else {
+        free(buffer);
+        buffer = NULL;
+      }
+    }
+  }
+  fclose(f);
+  return buffer;
+}
+
+static int compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+void lean_collect_files(const char *path, LeanPaths *paths) {
+  struct stat st;
+  if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+    array_push(paths, strdup(path));
+    return;
+  }
+
+  DIR *dir = opendir(path);
+  if (!dir)
+    return;
+  LeanPaths entries = array_new();
+  struct dirent *entry;
+  while ((entry = readdir(dir))) {
+    const char *name = entry->d_name;
+    if (name[0] == '.')
+      continue;
+    size_t length = strlen(path) + strlen(name) + 2;
+    char *child = malloc(length);
+    snprintf(child, length, "%s/%s", path, name);
+    array_push(&entries, child);
+  }
+  closedir(dir);
+
+  qsort(entries.contents, entries.size, sizeof(char *), compare_names);
+  for (uint32_t i = 0; i < entries.size; i++) {
+    char *child = entries.contents[i];
+    size_t length = strlen(child);
+    if (stat(child, &st) == 0 && S_ISDIR(st.st_mode))
+      lean_collect_files(child, paths);
+    else if (length > 5 && strcmp(child + length - 5, ".lean") == 0)
+      array_push(paths, strdup(child));
+    free(child);
+  }
+  array_delete(&entries);
+}
+
+void lean_paths_delete(LeanPaths *paths) {
+  for (uint32_t i = 0; i < paths->size; i++)
+    free(paths->contents[i]);
+  array_delete(paths);
+}
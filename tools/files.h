@@ -0,0 +1,25 @@
+#ifndef TREE_SITTER_LEAN_FILES_H_
+#define TREE_SITTER_LEAN_FILES_H_
+
+#include "tree_sitter/array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef Array(char *) LeanPaths;
+
+// Reads a whole file into a malloc'ed buffer, returning NULL on failure.
+char *lean_read_file(const char *path, uint32_t *length);
+
+// Appends `path` if it is a file, or every `.lean` file below it if it is a
+// directory. Paths are malloc'ed and sorted within each directory.
+void lean_collect_files(const char *path, LeanPaths *paths);
+
+void lean_paths_delete(LeanPaths *paths);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_LEAN_FILES_H_
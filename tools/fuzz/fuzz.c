@@ -0,0 +1,227 @@
+// Fuzz target for the Lean grammar and its external scanner.
+//
+// Besides crashes and sanitizer reports, it looks for inputs whose parse time
+// grows faster than their size, such as long runs of `|` without `=>`, deep
+// `(`/`⟨` nesting or raw strings with many `#`. Two checks abort on them:
+//
+//   LEAN_FUZZ_NS_PER_BYTE (default 20000)
+//     the maximum parse time per byte, for inputs of at least 1 KiB
+//
+//   LEAN_FUZZ_SCALING (default 0 under libFuzzer, 1 when replaying)
+//     when set, the input is repeated to ~8 KiB and to four times that, and
+//     the larger parse may take at most LEAN_FUZZ_SLACK (default 2.5) times
+//     as much longer as it is larger. If the input contains the comments
+//     `/- grow -/` and `/- end grow -/`, the text between them is grown the
+//     same way within the rest of the input, which catches costs that build
+//     up inside a single command
+//
+// Every input is also edited and reparsed incrementally, which exercises the
+// scanner's (de)serialization.
+//
+// Build with clang -fsanitize=fuzzer for libFuzzer. With -DLEAN_FUZZ_MAIN it
+// gets a main() that replays the files given on the command line (or stdin),
+// which is also how AFL and regression runs use it.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SCALING_SIZE 8192
+#define SCALING_FACTOR 4
+#define GROW_START "/- grow -/"
+#define GROW_END "/- end grow -/"
+
+static TSParser *parser;
+static double ns_per_byte_limit = 20000;
+static double slack = 2.5;
+static int scaling;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double env_number(const char *name, double fallback) {
+  const char *value = getenv(name);
+  return value && *value ? strtod(value, NULL) : fallback;
+}
+
+static void initialize(void) {
+  if (parser)
+    return;
+  parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_lean());
+  ns_per_byte_limit = env_number("LEAN_FUZZ_NS_PER_BYTE", ns_per_byte_limit);
+  slack = env_number("LEAN_FUZZ_SLACK", slack);
+  scaling = (int)env_number("LEAN_FUZZ_SCALING", scaling);
+}
+
+static double parse_ns(const char *text, uint32_t length) {
+  double start = now_ns();
+  ts_tree_delete(ts_parser_parse_string(parser, NULL, text, length));
+  return now_ns() - start;
+}
+
+// The fastest of three parses, to keep timer noise out of the comparison.
+static double best_parse_ns(const char *text, uint32_t length) {
+  double best = parse_ns(text, length);
+  for (int i = 0; i < 2; i++) {
+    double t = parse_ns(text, length);
+    if (t < best)
+      best = t;
+  }
+  return best;
+}
+
+static TSPoint advance_point(TSPoint point, const char *text, uint32_t length) {
+  for (uint32_t i = 0; i < length; i++) {
+    if (text[i] == '\n') {
+      point.row++;
+      point.column = 0;
+    } else {
+      point.column++;
+    }
+  }
+  return point;
+}
+
+// The input with its bytes [from, to) repeated `times` times.
+static char *repeat(const uint8_t *data, size_t size, size_t from, size_t to,
+                    uint32_t times, uint32_t *length) {
+  size_t middle = to - from;
+  *length = (uint32_t)(size - middle + middle * times);
+  char *text = malloc(*length ? *length : 1);
+  memcpy(text, data, from);
+  for (uint32_t i = 0; i < times; i++)
+    memcpy(text + from + i * middle, data + from, middle);
+  memcpy(text + from + times * middle, data + to, size - to);
+  return text;
+}
+
+static void check_scaling(const uint8_t *data, size_t size, size_t from,
+                          size_t to) {
+  uint32_t times = (uint32_t)((SCALING_SIZE + (to - from) - 1) / (to - from));
+  uint32_t small_length, large_length;
+  char *small_text = repeat(data, size, from, to, times, &small_length);
+  char *large_text =
+      repeat(data, size, from, to, times * SCALING_FACTOR, &large_length);
+
+  double small = best_parse_ns(small_text, small_length);
+  double big = best_parse_ns(large_text, large_length);
+  double ratio = (double)large_length / small_length;
+  free(small_text);
+  free(large_text);
+
+  // below a millisecond the ratio is mostly noise
+  if (big > 1e6 && big > small * ratio * slack) {
+    fprintf(stderr,
+            "superlinear input: %u bytes parse in %.3f ms, %u bytes in "
+            "%.3f ms (%.1fx for %.1fx the input)\n",
+            small_length, small / 1e6, large_length, big / 1e6, big / small,
+            ratio);
+    abort();
+  }
+}
+
+static const char *find(const uint8_t *data, size_t size, const char *needle) {
+  size_t length = strlen(needle);
+  for (size_t i = 0; i + length <= size; i++) {
+    if (memcmp(data + i, needle, length) == 0)
+      return (const char *)data + i;
+  }
+  return NULL;
+}
+
+// Checks the whole input, and the span between the grow markers if any.
+static void check_growth(const uint8_t *data, size_t size) {
+  check_scaling(data, size, 0, size);
+  const char *start = find(data, size, GROW_START);
+  if (!start)
+    return;
+  size_t from = (size_t)(start - (const char *)data) + strlen(GROW_START);
+  const char *end = find(data + from, size - from, GROW_END);
+  if (end && end > (const char *)data + from)
+    check_scaling(data, size, from, (size_t)(end - (const char *)data));
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  initialize();
+  if (size > UINT32_MAX / (2 * SCALING_FACTOR))
+    return 0;
+  const char *text = (const char *)data;
+  uint32_t length = (uint32_t)size;
+
+  double start = now_ns();
+  TSTree *tree = ts_parser_parse_string(parser, NULL, text, length);
+  double elapsed = now_ns() - start;
+  if (length >= 1024 && elapsed / length > ns_per_byte_limit) {
+    fprintf(stderr, "slow input: %u bytes parse in %.3f ms (%.0f ns/byte)\n",
+            length, elapsed / 1e6, elapsed / length);
+    abort();
+  }
+
+  // delete the middle third of the input and reparse incrementally
+  uint32_t from = length / 3, to = 2 * length / 3;
+  TSInputEdit edit = {
+      .start_byte = from, .old_end_byte = to, .new_end_byte = from};
+  edit.start_point = advance_point((TSPoint){0, 0}, text, from);
+  edit.old_end_point = advance_point(edit.start_point, text + from, to - from);
+  edit.new_end_point = edit.start_point;
+
+  char *edited = malloc(length - (to - from) + 1);
+  memcpy(edited, text, from);
+  memcpy(edited + from, text + to, length - to);
+  ts_tree_edit(tree, &edit);
+  TSTree *new_tree = ts_parser_parse_string(parser, tree, edited,
+                                            length - (to - from));
+  ts_tree_delete(new_tree);
+  ts_tree_delete(tree);
+  free(edited);
+
+  if (scaling && size)
+    check_growth(data, size);
+  return 0;
+}
+
+#ifdef LEAN_FUZZ_MAIN
+
+static int run(FILE *f, const char *name) {
+  size_t capacity = 4096, size = 0, n;
+  uint8_t *data = malloc(capacity);
+  while ((n = fread(data + size, 1, capacity - size, f)) > 0) {
+    size += n;
+    if (size == capacity)
+      data = realloc(data, capacity *= 2);
+  }
+  fprintf(stderr, "%s: %zu bytes\n", name, size);
+  LLVMFuzzerTestOneInput(data, size);
+  free(data);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  scaling = 1;
+  if (argc < 2)
+    return run(stdin, "<stdin>");
+  for (int i = 1; i < argc; i++) {
+    FILE *f = fopen(argv[i], "rb");
+    if (!f) {
+      perror(argv[i]);
+      return 1;
+    }
+    run(f, argv[i]);
+    fclose(f);
+  }
+  ts_parser_delete(parser);
+  return 0;
+}
+
+#endif
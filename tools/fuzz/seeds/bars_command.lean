@@ -0,0 +1,5 @@
+def f (x : Nat) : Nat := match x with
+  | /- grow -/| | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | | /- end grow -/
+  0
+
+def g := 1
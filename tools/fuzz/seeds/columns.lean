@@ -0,0 +1,3 @@
+def f : IO Unit := do
+                                                                                                                                                                                                                                                                                                            pure ()
+                                                                                                                                                                                                                                                                                                            pure ()
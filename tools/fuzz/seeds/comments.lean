@@ -0,0 +1,3 @@
+/- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- /- body -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/ -/
+
+def x := 1
@@ -0,0 +1,3 @@
+def s := r########################################################################################################################################################################################################"x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#x"#"########################################################################################################################################################################################################
+
+def t := r############################################################################################################################################################################################################################################################################################################"x"############################################################################################################################################################################################################################################################################################################
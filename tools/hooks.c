@@ -0,0 +1,67 @@
+#include "hooks.h"
+
+#include <tree_sitter/parser.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+static const TSLanguage *lean;
+static const LeanScannerHooks *hooks;
+
+static void enter(LeanScannerCall call) {
+  if (hooks->enter)
+    hooks->enter(hooks->payload, call);
+}
+
+static void leave(LeanScannerCall call, unsigned length) {
+  if (hooks->leave)
+    hooks->leave(hooks->payload, call, length);
+}
+
+static void *hooked_create(void) {
+  enter(LEAN_SCANNER_CREATE);
+  void *scanner = lean->external_scanner.create();
+  leave(LEAN_SCANNER_CREATE, 0);
+  return scanner;
+}
+
+static void hooked_destroy(void *payload) {
+  enter(LEAN_SCANNER_DESTROY);
+  lean->external_scanner.destroy(payload);
+  leave(LEAN_SCANNER_DESTROY, 0);
+}
+
+static bool hooked_scan(void *payload, TSLexer *lexer,
+                        const bool *valid_symbols) {
+  enter(LEAN_SCANNER_SCAN);
+  bool result = lean->external_scanner.scan(payload, lexer, valid_symbols);
+  leave(LEAN_SCANNER_SCAN, 0);
+  return result;
+}
+
+static unsigned hooked_serialize(void *payload, char *buffer) {
+  enter(LEAN_SCANNER_SERIALIZE);
+  unsigned length = lean->external_scanner.serialize(payload, buffer);
+  leave(LEAN_SCANNER_SERIALIZE, length);
+  return length;
+}
+
+static void hooked_deserialize(void *payload, const char *buffer,
+                               unsigned length) {
+  enter(LEAN_SCANNER_DESERIALIZE);
+  lean->external_scanner.deserialize(payload, buffer, length);
+  leave(LEAN_SCANNER_DESERIALIZE, 0);
+}
+
+const TSLanguage *lean_hooked_language(const LeanScannerHooks *new_hooks) {
+  // TSLanguage is laid out by src/tree_sitter/parser.h, which is generated
+  // along with src/parser.c, so the copy is field for field
+  static TSLanguage hooked;
+  lean = tree_sitter_lean();
+  hooks = new_hooks;
+  hooked = *lean;
+  hooked.external_scanner.create = hooked_create;
+  hooked.external_scanner.destroy = hooked_destroy;
+  hooked.external_scanner.scan = hooked_scan;
+  hooked.external_scanner.serialize = hooked_serialize;
+  hooked.external_scanner.deserialize = hooked_deserialize;
+  return &hooked;
+}
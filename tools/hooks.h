@@ -0,0 +1,39 @@
+#ifndef TREE_SITTER_LEAN_HOOKS_H_
+#define TREE_SITTER_LEAN_HOOKS_H_
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The external scanner callbacks, as called by the runtime.
+typedef enum {
+  LEAN_SCANNER_CREATE,
+  LEAN_SCANNER_DESTROY,
+  LEAN_SCANNER_SCAN,
+  LEAN_SCANNER_SERIALIZE,
+  LEAN_SCANNER_DESERIALIZE,
+} LeanScannerCall;
+
+// Callbacks run around every call of the runtime into the external scanner,
+// for the profiling tools. Either may be NULL.
+typedef struct {
+  void *payload;
+  void (*enter)(void *payload, LeanScannerCall call);
+  // `length` is the length of the state written by a serialize, else 0
+  void (*leave)(void *payload, LeanScannerCall call, unsigned length);
+} LeanScannerHooks;
+
+// A copy of the Lean language whose external scanner runs `hooks` around each
+// of its calls. The runtime hands the scanner callbacks nothing but the
+// scanner's own payload, so there is only one set of hooks at a time: a later
+// call replaces them, and `hooks` must stay valid while the language is used.
+// Its payload may be changed between parses.
+const TSLanguage *lean_hooked_language(const LeanScannerHooks *hooks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_LEAN_HOOKS_H_
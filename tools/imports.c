@@ -0,0 +1,421 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "imports.h"
+
+#include <tree_sitter/tree-sitter-lean-input.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// header scanning
+
+static bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Skips whitespace and comments, stopping at doc comments, which start
+// commands.
+static uint32_t skip_trivia(const char *s, uint32_t length, uint32_t i) {
+  while (i < length) {
+    if (is_space(s[i])) {
+      i++;
+    } else if (i + 1 < length && s[i] == '-' && s[i + 1] == '-') {
+      const char *newline = memchr(s + i, '\n', length - i);
+      i = newline ? (uint32_t)(newline - s) + 1 : length;
+    } else if (i + 2 < length && s[i] == '/' && s[i + 1] == '-' &&
+               s[i + 2] != '-' && s[i + 2] != '!') {
+      uint32_t depth = 1;
+      for (i += 2; i < length && depth > 0; i++) {
+        if (i + 1 < length && s[i] == '/' && s[i + 1] == '-')
+          depth++, i++;
+        else if (i + 1 < length && s[i] == '-' && s[i + 1] == '/')
+          depth--, i++;
+      }
+    } else {
+      break;
+    }
+  }
+  return i;
+}
+
+// The end of the word at `i`, `«...»` segments included.
+static uint32_t word_end(const char *s, uint32_t length, uint32_t i) {
+  while (i < length && !is_space(s[i])) {
+    if (i + 1 < length && s[i] == '-' && s[i + 1] == '-')
+      break;
+    if (i + 1 < length && (uint8_t)s[i] == 0xc2 && (uint8_t)s[i + 1] == 0xab) {
+      const char *close = NULL;
+      for (uint32_t j = i + 2; j + 1 < length; j++) {
+        if ((uint8_t)s[j] == 0xc2 && (uint8_t)s[j + 1] == 0xbb) {
+          close = s + j;
+          break;
+        }
+      }
+      i = close ? (uint32_t)(close - s) + 2 : length;
+      continue;
+    }
+    i++;
+  }
+  return i;
+}
+
+static bool word_is(const char *s, uint32_t start, uint32_t end,
+                    const char *word) {
+  size_t n = strlen(word);
+  return end - start == n && memcmp(s + start, word, n) == 0;
+}
+
+uint32_t lean_header_end(const char *source, uint32_t length) {
+  uint32_t i = skip_trivia(source, length, 0);
+  bool expect_module = false;
+  while (i < length) {
+    uint32_t end = word_end(source, length, i);
+    if (end == i)
+      break;
+    if (expect_module) {
+      // the module follows `import all`
+      expect_module = word_is(source, i, end, "all");
+    } else if (word_is(source, i, end, "import")) {
+      expect_module = true;
+    } else if (word_is(source, i, end, "private")) {
+      // `private import`, as opposed to a private declaration
+      uint32_t next = skip_trivia(source, length, end);
+      if (!word_is(source, next, word_end(source, length, next), "import"))
+        break;
+    } else if (!word_is(source, i, end, "module") &&
+               !word_is(source, i, end, "prelude")) {
+      break;
+    }
+    i = skip_trivia(source, length, end);
+  }
+  return i;
+}
+
+static char *module_name(const char *text, uint32_t length) {
+  char *name = malloc(length + 1), *p = name;
+  for (uint32_t i = 0; i < length; i++) {
+    if (i + 1 < length && (uint8_t)text[i] == 0xc2 &&
+        ((uint8_t)text[i + 1] == 0xab || (uint8_t)text[i + 1] == 0xbb)) {
+      i++;
+      continue;
+    }
+    *p++ = text[i];
+  }
+  *p = '\0';
+  return name;
+}
+
+TSTree *lean_header_parse(TSParser *parser, const char *source,
+                          uint32_t length) {
+  uint32_t end = lean_header_end(source, length);
+  uint32_t row = 0, column = 0;
+  for (uint32_t i = 0; i < end; i++) {
+    if (source[i] == '\n')
+      row++, column = 0;
+    else
+      column++;
+  }
+  TSRange header = {{0, 0}, {row, column}, 0, end};
+  ts_parser_set_included_ranges(parser, &header, 1);
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+  ts_parser_set_included_ranges(parser, NULL, 0);
+  return tree;
+}
+
+void lean_imports_scan(TSParser *parser, const char *source, uint32_t length,
+                       LeanImports *imports) {
+  TSTree *tree = lean_header_parse(parser, source, length);
+  if (!tree)
+    return;
+
+  TSNode root = ts_tree_root_node(tree);
+  uint32_t count = ts_node_named_child_count(root);
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode node = ts_node_named_child(root, i);
+    if (strcmp(ts_node_type(node), "import") != 0)
+      continue;
+    LeanImport import = {0};
+    uint32_t child_count = ts_node_child_count(node);
+    for (uint32_t j = 0; j < child_count; j++) {
+      TSNode child = ts_node_child(node, j);
+      const char *type = ts_node_type(child);
+      if (strcmp(type, "private") == 0) {
+        import.is_private = true;
+      } else if (strcmp(type, "all") == 0) {
+        import.all = true;
+      } else if (strcmp(type, "ident") == 0) {
+        uint32_t start = ts_node_start_byte(child);
+        import.module =
+            module_name(source + start, ts_node_end_byte(child) - start);
+      }
+    }
+    if (import.module)
+      array_push(imports, import);
+  }
+  ts_tree_delete(tree);
+}
+
+void lean_imports_delete(LeanImports *imports) {
+  for (uint32_t i = 0; i < imports->size; i++)
+    free(imports->contents[i].module);
+  array_delete(imports);
+}
+
+// wave scheduling
+
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t wave_done;
+  const uint32_t *order;
+  const uint32_t *waves;
+  uint32_t wave_count;
+  // the current wave, the next module of `order` to hand out, and the number
+  // of modules finished, all waves so far included
+  uint32_t wave;
+  uint32_t next;
+  uint32_t done;
+  LeanModuleTask task;
+  void *payload;
+} Schedule;
+
+typedef struct {
+  Schedule *schedule;
+  unsigned id;
+} Worker;
+
+static void *run_worker(void *payload) {
+  Worker *worker = payload;
+  Schedule *self = worker->schedule;
+  pthread_mutex_lock(&self->lock);
+  for (;;) {
+    // the wave is handed out, wait for the stragglers
+    while (self->wave < self->wave_count &&
+           self->next == self->waves[self->wave])
+      pthread_cond_wait(&self->wave_done, &self->lock);
+    if (self->wave == self->wave_count)
+      break;
+    uint32_t i = self->next++;
+    pthread_mutex_unlock(&self->lock);
+    self->task(self->payload, self->order[i], worker->id);
+    pthread_mutex_lock(&self->lock);
+    if (++self->done == self->waves[self->wave]) {
+      self->wave++;
+      pthread_cond_broadcast(&self->wave_done);
+    }
+  }
+  pthread_mutex_unlock(&self->lock);
+  return NULL;
+}
+
+static unsigned thread_count(unsigned threads) {
+  if (threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cpus > 0 ? (unsigned)cpus : 1;
+  }
+  return threads;
+}
+
+static void run_waves(const uint32_t *order, const uint32_t *waves,
+                      uint32_t wave_count, unsigned threads,
+                      LeanModuleTask task, void *payload) {
+  Schedule schedule = {
+      .order = order,
+      .waves = waves,
+      .wave_count = wave_count,
+      .task = task,
+      .payload = payload,
+  };
+  pthread_mutex_init(&schedule.lock, NULL);
+  pthread_cond_init(&schedule.wave_done, NULL);
+
+  // the calling thread is worker 0
+  Worker *workers = malloc(threads * sizeof(Worker));
+  pthread_t *handles = malloc(threads * sizeof(pthread_t));
+  unsigned started = 1;
+  for (unsigned i = 0; i < threads; i++)
+    workers[i] = (Worker){&schedule, i};
+  for (; started < threads; started++)
+    if (pthread_create(&handles[started], NULL, run_worker,
+                       &workers[started]) != 0)
+      break;
+  run_worker(&workers[0]);
+  for (unsigned i = 1; i < started; i++)
+    pthread_join(handles[i], NULL);
+
+  free(handles);
+  free(workers);
+  pthread_cond_destroy(&schedule.wave_done);
+  pthread_mutex_destroy(&schedule.lock);
+}
+
+void lean_import_graph_run(const LeanImportGraph *graph, unsigned threads,
+                           LeanModuleTask task, void *payload) {
+  if (graph->order.size == 0)
+    return;
+  run_waves(graph->order.contents, graph->waves.contents, graph->waves.size,
+            thread_count(threads), task, payload);
+}
+
+// graph construction
+
+typedef struct {
+  LeanImportGraph *graph;
+  TSParser **parsers;
+} Scan;
+
+static void scan_module(void *payload, uint32_t index, unsigned worker) {
+  Scan *scan = payload;
+  LeanModule *module = &scan->graph->modules.contents[index];
+  TreeSitterLeanFile file;
+  if (tree_sitter_lean_file_open(&file, module->path) != 0)
+    return;
+  lean_imports_scan(scan->parsers[worker], file.data, (uint32_t)file.length,
+                    &module->imports);
+  tree_sitter_lean_file_close(&file);
+}
+
+static char *path_module_name(const char *path, const char *root) {
+  size_t root_length = root ? strlen(root) : 0;
+  while (root_length > 0 && root[root_length - 1] == '/')
+    root_length--;
+  if (root_length > 0 && strncmp(path, root, root_length) == 0 &&
+      path[root_length] == '/') {
+    path += root_length;
+    while (*path == '/')
+      path++;
+  }
+
+  size_t length = strlen(path);
+  if (length > 5 && strcmp(path + length - 5, ".lean") == 0)
+    length -= 5;
+  char *name = malloc(length + 1);
+  for (size_t i = 0; i < length; i++)
+    name[i] = path[i] == '/' ? '.' : path[i];
+  name[length] = '\0';
+  return name;
+}
+
+typedef struct {
+  const char *name;
+  uint32_t index;
+} ModuleName;
+
+static int compare_module_names(const void *a, const void *b) {
+  return strcmp(((const ModuleName *)a)->name, ((const ModuleName *)b)->name);
+}
+
+// The index of the module called `name`, or UINT32_MAX.
+static uint32_t find_module(const ModuleName *names, uint32_t count,
+                            const char *name) {
+  uint32_t low = 0, high = count;
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    int order = strcmp(names[mid].name, name);
+    if (order == 0)
+      return names[mid].index;
+    if (order < 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return UINT32_MAX;
+}
+
+void lean_import_graph_build(LeanImportGraph *graph, const LeanPaths *paths,
+                             const char *root, unsigned threads) {
+  *graph = (LeanImportGraph){0};
+  uint32_t n = paths->size;
+  if (n == 0)
+    return;
+  array_reserve(&graph->modules, n);
+  for (uint32_t i = 0; i < n; i++) {
+    LeanModule module = {
+        .path = strdup(paths->contents[i]),
+        .name = path_module_name(paths->contents[i], root),
+        .imports = array_new(),
+        .deps = array_new(),
+        .wave = LEAN_NO_WAVE,
+    };
+    array_push(&graph->modules, module);
+  }
+
+  // headers, all in a single wave
+  threads = thread_count(threads);
+  TSParser **parsers = malloc(threads * sizeof(TSParser *));
+  for (unsigned i = 0; i < threads; i++) {
+    parsers[i] = ts_parser_new();
+    ts_parser_set_language(parsers[i], tree_sitter_lean());
+  }
+  uint32_t *indices = malloc(n * sizeof(uint32_t));
+  for (uint32_t i = 0; i < n; i++)
+    indices[i] = i;
+  Scan scan = {graph, parsers};
+  run_waves(indices, &n, 1, threads, scan_module, &scan);
+  for (unsigned i = 0; i < threads; i++)
+    ts_parser_delete(parsers[i]);
+  free(parsers);
+  free(indices);
+
+  // edges, resolved by binary search on the names
+  ModuleName *names = malloc(n * sizeof(ModuleName));
+  for (uint32_t i = 0; i < n; i++)
+    names[i] = (ModuleName){graph->modules.contents[i].name, i};
+  qsort(names, n, sizeof(ModuleName), compare_module_names);
+  uint32_t *pending = calloc(n, sizeof(uint32_t));
+  Array(uint32_t) *dependents = calloc(n, sizeof(*dependents));
+  for (uint32_t i = 0; i < n; i++) {
+    LeanModule *module = &graph->modules.contents[i];
+    for (uint32_t j = 0; j < module->imports.size; j++) {
+      uint32_t dep = find_module(names, n, module->imports.contents[j].module);
+      if (dep == UINT32_MAX) {
+        graph->external_imports++;
+        continue;
+      }
+      array_push(&module->deps, dep);
+      array_push(&dependents[dep], i);
+      pending[i]++;
+    }
+  }
+
+  // waves, by Kahn's algorithm one level at a time
+  for (uint32_t i = 0; i < n; i++)
+    if (pending[i] == 0)
+      array_push(&graph->order, i);
+  for (uint32_t start = 0, wave = 0; start < graph->order.size; wave++) {
+    uint32_t end = graph->order.size;
+    array_push(&graph->waves, end);
+    for (uint32_t i = start; i < end; i++) {
+      uint32_t index = graph->order.contents[i];
+      graph->modules.contents[index].wave = wave;
+      for (uint32_t j = 0; j < dependents[index].size; j++) {
+        uint32_t dependent = dependents[index].contents[j];
+        if (--pending[dependent] == 0)
+          array_push(&graph->order, dependent);
+      }
+    }
+    start = end;
+  }
+  graph->cyclic = n - graph->order.size;
+
+  for (uint32_t i = 0; i < n; i++)
+    array_delete(&dependents[i]);
+  free(dependents);
+  free(pending);
+  free(names);
+}
+
+void lean_import_graph_delete(LeanImportGraph *graph) {
+  for (uint32_t i = 0; i < graph->modules.size; i++) {
+    LeanModule *module = &graph->modules.contents[i];
+    free(module->path);
+    free(module->name);
+    lean_imports_delete(&module->imports);
+    array_delete(&module->deps);
+  }
+  array_delete(&graph->modules);
+  array_delete(&graph->order);
+  array_delete(&graph->waves);
+}
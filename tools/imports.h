@@ -0,0 +1,84 @@
+#ifndef TREE_SITTER_LEAN_IMPORTS_H_
+#define TREE_SITTER_LEAN_IMPORTS_H_
+
+#include "files.h"
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An `import` of a file header. `module` is malloc'ed, with any «» guillemets
+// removed so that it can be compared with module names derived from paths.
+typedef struct {
+  char *module;
+  bool is_private;
+  bool all;
+} LeanImport;
+
+typedef Array(LeanImport) LeanImports;
+
+// The end of the header of `source`: `module`, `prelude` and the imports,
+// with the whitespace and comments around them. Only this prefix has to be
+// parsed to know the imports of a file.
+uint32_t lean_header_end(const char *source, uint32_t length);
+
+// Parses the header of `source` and nothing past it, so the tree has no
+// commands. The parser's included ranges are reset afterwards.
+TSTree *lean_header_parse(TSParser *parser, const char *source,
+                          uint32_t length);
+
+// Parses the header of `source`, and nothing past it, appending its imports.
+void lean_imports_scan(TSParser *parser, const char *source, uint32_t length,
+                       LeanImports *imports);
+
+void lean_imports_delete(LeanImports *imports);
+
+#define LEAN_NO_WAVE UINT32_MAX
+
+typedef struct {
+  char *path;
+  // `A.B.C` for `<root>/A/B/C.lean`
+  char *name;
+  LeanImports imports;
+  // indices of the imported modules of the graph, external ones left out
+  Array(uint32_t) deps;
+  // 1 + the wave of its latest dependency, or LEAN_NO_WAVE for modules in or
+  // depending on an import cycle
+  uint32_t wave;
+} LeanModule;
+
+typedef struct {
+  Array(LeanModule) modules;
+  // indices of the scheduled modules, wave by wave
+  Array(uint32_t) order;
+  // the end of each wave in `order`
+  Array(uint32_t) waves;
+  // imports of modules outside the graph (`Init`, `Std`, other packages)
+  uint32_t external_imports;
+  // modules left unscheduled because of import cycles
+  uint32_t cyclic;
+} LeanImportGraph;
+
+// Called for module `index` of a graph by worker `worker` (below the thread
+// count), so that callers can keep one parser per worker.
+typedef void (*LeanModuleTask)(void *payload, uint32_t index, unsigned worker);
+
+// Scans the headers of `paths` on `threads` threads (0 for one per CPU) and
+// builds their import graph. Module names are the paths relative to `root`.
+void lean_import_graph_build(LeanImportGraph *graph, const LeanPaths *paths,
+                             const char *root, unsigned threads);
+
+// Runs `task` for every scheduled module on `threads` threads, one wave at a
+// time: a module only starts once all its dependencies are done.
+void lean_import_graph_run(const LeanImportGraph *graph, unsigned threads,
+                           LeanModuleTask task, void *payload);
+
+void lean_import_graph_delete(LeanImportGraph *graph);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_LEAN_IMPORTS_H_
@@ -0,0 +1,314 @@
+#include "json.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  const char *text;
+  size_t length;
+  size_t position;
+} JsonReader;
+
+static inline void skip_whitespace(JsonReader *reader) {
+  while (reader->position < reader->length) {
+    char c = reader->text[reader->position];
+    if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+      break;
+    reader->position++;
+  }
+}
+
+static inline int peek(JsonReader *reader) {
+  return reader->position < reader->length
+             ? (unsigned char)reader->text[reader->position]
+             : -1;
+}
+
+static bool consume(JsonReader *reader, const char *literal) {
+  size_t n = strlen(literal);
+  if (reader->length - reader->position < n ||
+      memcmp(reader->text + reader->position, literal, n) != 0)
+    return false;
+  reader->position += n;
+  return true;
+}
+
+static int hex_digit(int c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+static bool read_hex4(JsonReader *reader, uint32_t *code) {
+  if (reader->length - reader->position < 4)
+    return false;
+  *code = 0;
+  for (int i = 0; i < 4; i++) {
+    int d = hex_digit((unsigned char)reader->text[reader->position++]);
+    if (d < 0)
+      return false;
+    *code = *code << 4 | (uint32_t)d;
+  }
+  return true;
+}
+
+static void push_utf8(JsonBuffer *out, uint32_t code) {
+  if (code < 0x80) {
+    array_push(out, (char)code);
+  } else if (code < 0x800) {
+    array_push(out, (char)(0xc0 | code >> 6));
+    array_push(out, (char)(0x80 | (code & 0x3f)));
+  } else if (code < 0x10000) {
+    array_push(out, (char)(0xe0 | code >> 12));
+    array_push(out, (char)(0x80 | (code >> 6 & 0x3f)));
+    array_push(out, (char)(0x80 | (code & 0x3f)));
+  } else {
+    array_push(out, (char)(0xf0 | code >> 18));
+    array_push(out, (char)(0x80 | (code >> 12 & 0x3f)));
+    array_push(out, (char)(0x80 | (code >> 6 & 0x3f)));
+    array_push(out, (char)(0x80 | (code & 0x3f)));
+  }
+}
+
+// Reads a string literal, returning a malloc'ed NUL-terminated copy.
+static char *read_string(JsonReader *reader, uint32_t *length) {
+  if (peek(reader) != '"')
+    return NULL;
+  reader->position++;
+
+  JsonBuffer out = array_new();
+  for (;;) {
+    int c = peek(reader);
+    if (c < 0 || c < 0x20)
+      goto fail;
+    reader->position++;
+    if (c == '"')
+      break;
+    if (c != '\\') {
+      array_push(&out, (char)c);
+      continue;
+    }
+
+    c = peek(reader);
+    reader->position++;
+    switch (c) {
+    case '"':
+    case '\\':
+    case '/':
+      array_push(&out, (char)c);
+      break;
+    case 'b':
+      array_push(&out, '\b');
+      break;
+    case 'f':
+      array_push(&out, '\f');
+      break;
+    case 'n':
+      array_push(&out, '\n');
+      break;
+    case 'r':
+      array_push(&out, '\r');
+      break;
+    case 't':
+      array_push(&out, '\t');
+      break;
+    case 'u': {
+      uint32_t code, low;
+      if (!read_hex4(reader, &code))
+        goto fail;
+      if (code >= 0xd800 && code < 0xdc00 && consume(reader, "\\u") &&
+          read_hex4(reader, &low) && low >= 0xdc00 && low < 0xe000)
+        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+      push_utf8(&out, code);
+      break;
+    }
+    default:
+      goto fail;
+    }
+  }
+
+  *length = out.size;
+  array_push(&out, '\0');
+  return out.contents;
+
+fail:
+  array_delete(&out);
+  return NULL;
+}
+
+static JsonValue *read_value(JsonReader *reader, unsigned depth);
+
+static JsonValue *read_container(JsonReader *reader, JsonValue *value,
+                                 char close, unsigned depth) {
+  reader->position++;
+  JsonValue **tail = &value->child;
+  skip_whitespace(reader);
+  if (peek(reader) == close) {
+    reader->position++;
+    return value;
+  }
+
+  for (;;) {
+    char *key = NULL;
+    if (value->type == JSON_OBJECT) {
+      uint32_t key_length;
+      skip_whitespace(reader);
+      if (!(key = read_string(reader, &key_length)))
+        goto fail;
+      skip_whitespace(reader);
+      if (peek(reader) != ':') {
+        free(key);
+        goto fail;
+      }
+      reader->position++;
+    }
+
+    JsonValue *element = read_value(reader, depth + 1);
+    if (!element) {
+      free(key);
+      goto fail;
+    }
+    element->key = key;
+    *tail = element;
+    tail = &element->next;
+
+    skip_whitespace(reader);
+    int c = peek(reader);
+    reader->position++;
+    if (c == close)
+      return value;
+    if (c != ',')
+      goto fail;
+  }
+
+fail:
+  json_free(value);
+  return NULL;
+}
+
+static JsonValue *read_value(JsonReader *reader, unsigned depth) {
+  // deeply nested input is rejected rather than recursed into
+  if (depth > 512)
+    return NULL;
+
+  skip_whitespace(reader);
+  JsonValue *value = calloc(1, sizeof(JsonValue));
+  int c = peek(reader);
+  switch (c) {
+  case '{':
+    value->type = JSON_OBJECT;
+    return read_container(reader, value, '}', depth);
+  case '[':
+    value->type = JSON_ARRAY;
+    return read_container(reader, value, ']', depth);
+  case '"':
+    value->type = JSON_STRING;
+    if (!(value->string = read_string(reader, &value->length)))
+      break;
+    return value;
+  case 'n':
+    if (!consume(reader, "null"))
+      break;
+    return value;
+  case 't':
+    value->type = JSON_TRUE;
+    if (!consume(reader, "true"))
+      break;
+    return value;
+  case 'f':
+    value->type = JSON_FALSE;
+    if (!consume(reader, "false"))
+      break;
+    return value;
+  default: {
+    if (c != '-' && (c < '0' || c > '9'))
+      break;
+    // strtod needs a NUL-terminated string, numbers are short
+    char number[64];
+    size_t n = 0;
+    while (n + 1 < sizeof(number) && reader->position < reader->length &&
+           strchr("+-.0123456789eE", reader->text[reader->position]))
+      number[n++] = reader->text[reader->position++];
+    number[n] = '\0';
+    char *end;
+    value->type = JSON_NUMBER;
+    value->number = strtod(number, &end);
+    if (end != number + n)
+      break;
+    return value;
+  }
+  }
+
+  json_free(value);
+  return NULL;
+}
+
+JsonValue *json_parse(const char *text, size_t length) {
+  JsonReader reader = {.text = text, .length = length};
+  JsonValue *value = read_value(&reader, 0);
+  skip_whitespace(&reader);
+  if (value && reader.position != length) {
+    json_free(value);
+    return NULL;
+  }
+  return value;
+}
+
+void json_free(JsonValue *value) {
+  while (value) {
+    JsonValue *next = value->next;
+    json_free(value->child);
+    free(value->string);
+    free(value->key);
+    free(value);
+    value = next;
+  }
+}
+
+const JsonValue *json_get(const JsonValue *object, const char *key) {
+  if (!object || object->type != JSON_OBJECT)
+    return NULL;
+  for (const JsonValue *member = object->child; member; member = member->next) {
+    if (strcmp(member->key, key) == 0)
+      return member;
+  }
+  return NULL;
+}
+
+void json_write_string(JsonBuffer *buffer, const char *string, size_t length) {
+  array_push(buffer, '"');
+  for (size_t i = 0; i < length; i++) {
+    unsigned char c = (unsigned char)string[i];
+    if (c == '"' || c == '\\') {
+      array_push(buffer, '\\');
+      array_push(buffer, (char)c);
+    } else if (c == '\n') {
+      array_extend(buffer, 2, "\\n");
+    } else if (c < 0x20) {
+      json_printf(buffer, "\\u%04x", c);
+    } else {
+      array_push(buffer, (char)c);
+    }
+  }
+  array_push(buffer, '"');
+}
+
+void json_printf(JsonBuffer *buffer, const char *format, ...) {
+  va_list args, copy;
+  va_start(args, format);
+  va_copy(copy, args);
+  int n = vsnprintf(NULL, 0, format, copy);
+  va_end(copy);
+  if (n > 0) {
+    array_reserve(buffer, buffer->size + (uint32_t)n + 1);
+    vsnprintf(buffer->contents + buffer->size, (size_t)n + 1, format, args);
+    buffer->size += (uint32_t)n;
+  }
+  va_end(args);
+}
@@ -0,0 +1,61 @@
+#ifndef TREE_SITTER_LEAN_JSON_H_
+#define TREE_SITTER_LEAN_JSON_H_
+
+#include "tree_sitter/array.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A minimal JSON reader and writer, just enough for the JSON-RPC messages
+// exchanged by the tools.
+
+typedef enum {
+  JSON_NULL,
+  JSON_FALSE,
+  JSON_TRUE,
+  JSON_NUMBER,
+  JSON_STRING,
+  JSON_ARRAY,
+  JSON_OBJECT,
+} JsonType;
+
+typedef struct JsonValue JsonValue;
+
+struct JsonValue {
+  JsonType type;
+  double number;
+  // unescaped and NUL-terminated, for JSON_STRING
+  char *string;
+  uint32_t length;
+  // set on the members of a JSON_OBJECT
+  char *key;
+  // first element/member of a JSON_ARRAY/JSON_OBJECT
+  JsonValue *child;
+  JsonValue *next;
+};
+
+// Parses `text`, returning NULL if it isn't valid JSON.
+JsonValue *json_parse(const char *text, size_t length);
+
+void json_free(JsonValue *value);
+
+// The member of `object` named `key`, or NULL if `object` isn't an object or
+// has no such member.
+const JsonValue *json_get(const JsonValue *object, const char *key);
+
+typedef Array(char) JsonBuffer;
+
+// Appends `string` as a quoted and escaped JSON string.
+void json_write_string(JsonBuffer *buffer, const char *string, size_t length);
+
+// Appends formatted text verbatim.
+void json_printf(JsonBuffer *buffer, const char *format, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_LEAN_JSON_H_
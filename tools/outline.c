@@ -0,0 +1,137 @@
+#include "outline.h"
+
+#include <string.h>
+
+static inline bool node_is(TSNode node, const char *type) {
+  return strcmp(ts_node_type(node), type) == 0;
+}
+
+static inline TSRange node_range(TSNode node) {
+  return (TSRange){
+      .start_point = ts_node_start_point(node),
+      .end_point = ts_node_end_point(node),
+      .start_byte = ts_node_start_byte(node),
+      .end_byte = ts_node_end_byte(node),
+  };
+}
+
+// The name of an outline entry is its first `decl_ident` (without universe
+// parameters) or `ident` child.
+static TSNode find_name(TSNode node) {
+  uint32_t count = ts_node_named_child_count(node);
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode child = ts_node_named_child(node, i);
+    if (node_is(child, "decl_ident"))
+      return ts_node_named_child(child, 0);
+    if (node_is(child, "ident"))
+      return child;
+  }
+  return (TSNode){0};
+}
+
+// The first (or last) named child of `node`, ignoring comments.
+static TSNode named_child(TSNode node, bool last) {
+  uint32_t count = ts_node_named_child_count(node);
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode child = ts_node_named_child(node, last ? count - 1 - i : i);
+    if (!ts_node_is_extra(child))
+      return child;
+  }
+  return (TSNode){0};
+}
+
+TSNode lean_command_node(TSNode command) {
+  if (ts_node_is_null(command))
+    return command;
+  TSNode cmd = named_child(command, false);
+  if (ts_node_is_null(cmd))
+    return cmd;
+  const char *type = ts_node_type(cmd);
+
+  // `cmd in cmd`: the trailing command is the interesting one
+  if (strcmp(type, "cmd_in") == 0)
+    return lean_command_node(named_child(cmd, true));
+
+  // the declaration comes after its modifiers
+  if (strcmp(type, "cmd_declaration") == 0)
+    return named_child(cmd, true);
+
+  return cmd;
+}
+
+// The node an outline entry is described by, or a null node if `command`
+// doesn't belong in the outline (`open`, `set_option`, `variable`, ...).
+static TSNode outline_node(TSNode command) {
+  TSNode node = lean_command_node(command);
+  if (ts_node_is_null(node))
+    return node;
+
+  // declarations are the only nodes that aren't `cmd_*`
+  const char *type = ts_node_type(node);
+  if (strncmp(type, "cmd_", 4) != 0)
+    return node;
+
+  static const char *const kinds[] = {
+      "cmd_namespace", "cmd_section", "cmd_noncomputable_section",
+      "cmd_initialize", "cmd_mutual",  "cmd_mixfix",
+      "cmd_notation",  "cmd_syntax",  "cmd_macro_rules",
+  };
+  for (size_t i = 0; i < sizeof(kinds) / sizeof(*kinds); i++) {
+    if (strcmp(type, kinds[i]) == 0)
+      return node;
+  }
+  return (TSNode){0};
+}
+
+void lean_outline_collect(TSNode root, LeanOutline *outline) {
+  uint32_t count = ts_node_named_child_count(root);
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode command = ts_node_named_child(root, i);
+    if (!node_is(command, "command"))
+      continue;
+    TSNode node = outline_node(command);
+    if (ts_node_is_null(node))
+      continue;
+
+    TSNode name = find_name(node);
+    LeanOutlineItem item = {
+        .kind = ts_node_type(node),
+        .symbol = ts_node_symbol(node),
+        .range = node_range(command),
+    };
+    if (!ts_node_is_null(name))
+      item.name = node_range(name);
+    else {
+      item.name.start_byte = item.name.end_byte = item.range.start_byte;
+      item.name.start_point = item.name.end_point = item.range.start_point;
+    }
+    array_push(outline, item);
+  }
+}
+
+void lean_syntax_errors_collect(TSNode root, LeanSyntaxErrors *errors) {
+  if (!ts_node_has_error(root))
+    return;
+
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    bool error = ts_node_is_error(node), missing = ts_node_is_missing(node);
+    if (error || missing) {
+      LeanSyntaxError e = {.range = node_range(node), .missing = missing};
+      array_push(errors, e);
+    }
+
+    // subtrees without errors are skipped as a whole
+    if (!missing && ts_node_has_error(node) &&
+        ts_tree_cursor_goto_first_child(&cursor))
+      continue;
+
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return;
+      }
+    }
+  }
+}
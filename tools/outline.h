@@ -0,0 +1,48 @@
+#ifndef TREE_SITTER_LEAN_OUTLINE_H_
+#define TREE_SITTER_LEAN_OUTLINE_H_
+
+#include "tree_sitter/array.h"
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An entry of a document outline: a top-level declaration, namespace, section
+// or syntax extension. `kind` is the node type that best describes the entry
+// (`theorem` rather than `cmd_declaration`) and points to static storage.
+typedef struct {
+  const char *kind;
+  TSSymbol symbol;
+  TSRange range;
+  // empty (start_byte == end_byte) for anonymous entries such as `example`
+  TSRange name;
+} LeanOutlineItem;
+
+// An ERROR node, or a MISSING node inserted during error recovery.
+typedef struct {
+  TSRange range;
+  bool missing;
+} LeanSyntaxError;
+
+typedef Array(LeanOutlineItem) LeanOutline;
+typedef Array(LeanSyntaxError) LeanSyntaxErrors;
+
+// The node describing a top-level `command`: the declaration itself for
+// `cmd_declaration` (`theorem`, `structure`, ...), the trailing command for
+// `cmd_in`, and the `cmd_*` node otherwise. Null for an empty command.
+TSNode lean_command_node(TSNode command);
+
+// Appends the outline entries of a `module` node, in source order.
+void lean_outline_collect(TSNode root, LeanOutline *outline);
+
+// Appends the syntax errors under `root`, in source order. Only subtrees that
+// contain errors are visited.
+void lean_syntax_errors_collect(TSNode root, LeanSyntaxErrors *errors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_LEAN_OUTLINE_H_
@@ -0,0 +1,411 @@
+// Attributes parse cost to the kinds of top-level commands and tactics.
+//
+// usage: tree-sitter-lean-profile [-n iterations] [-s column] path...
+//
+// Every byte of a file is labelled with the kind of the innermost top-level
+// command or tactic enclosing it: `cmd_declaration/theorem`, `cmd_macro_rules`,
+// `tactic_other/simp`, ... Bytes outside any command (the header, comments
+// between commands) are labelled `(other)`. Costs are measured per byte and
+// summed per kind:
+//
+//   time   sampled from the parse progress callback, which reports the byte
+//          offset reached by the parser every hundred or so operations
+//   chars  characters visited by the lexer, counted by handing the parser one
+//          character per TSInput read
+//   scans  calls to the external scanner's `scan`, counted through hooks.h
+//   nodes  nodes of the final tree, by start byte
+//
+// Directories are searched for `.lean` files. The report is sorted by the
+// column given to -s (time, bytes, chars, scans or nodes; default time).
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "files.h"
+#include "hooks.h"
+#include "outline.h"
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+  char *name;
+  uint64_t count;
+  uint64_t bytes;
+  uint64_t chars;
+  uint64_t scans;
+  uint64_t nodes;
+  double time;
+} Kind;
+
+typedef Array(Kind) Kinds;
+
+typedef struct {
+  uint32_t offset;
+  double time;
+} Sample;
+
+typedef struct {
+  double last;
+  Array(Sample) samples;
+} Timer;
+
+typedef struct {
+  const char *text;
+  uint32_t length;
+  uint32_t position;
+  const uint32_t *labels;
+  Kinds *kinds;
+} Counter;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t kind_index(Kinds *kinds, const char *name, size_t length) {
+  for (uint32_t i = 0; i < kinds->size; i++) {
+    const char *other = kinds->contents[i].name;
+    if (strncmp(other, name, length) == 0 && other[length] == '\0')
+      return i;
+  }
+  Kind kind = {.name = malloc(length + 1)};
+  memcpy(kind.name, name, length);
+  kind.name[length] = '\0';
+  array_push(kinds, kind);
+  return kinds->size - 1;
+}
+
+// labels
+
+static void label_range(uint32_t *labels, TSNode node, uint32_t kind,
+                        Kinds *kinds) {
+  uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+  for (uint32_t i = start; i < end; i++)
+    labels[i] = kind;
+  kinds->contents[kind].count++;
+}
+
+static uint32_t command_kind(TSNode command, Kinds *kinds) {
+  TSNode node = lean_command_node(command);
+  if (ts_node_is_null(node))
+    return kind_index(kinds, "command", 7);
+
+  char name[128];
+  TSNode parent = ts_node_parent(node);
+  if (strcmp(ts_node_type(parent), "cmd_declaration") == 0)
+    snprintf(name, sizeof(name), "cmd_declaration/%s", ts_node_type(node));
+  else
+    snprintf(name, sizeof(name), "%s", ts_node_type(node));
+  return kind_index(kinds, name, strlen(name));
+}
+
+// `tactic_other` covers every tactic without a dedicated rule, so it is
+// further split by the tactic's name.
+static uint32_t tactic_kind(TSNode tactic, const char *text, Kinds *kinds) {
+  TSNode node = ts_node_named_child(tactic, 0);
+  if (ts_node_is_null(node))
+    return kind_index(kinds, "tactic_p", 8);
+  const char *type = ts_node_type(node);
+  if (strcmp(type, "tactic_other") != 0)
+    return kind_index(kinds, type, strlen(type));
+
+  char name[128];
+  TSNode ident = ts_node_named_child(node, 0);
+  uint32_t start = ts_node_start_byte(ident), end = ts_node_end_byte(ident);
+  snprintf(name, sizeof(name), "tactic_other/%.*s",
+           (int)(end - start < 64 ? end - start : 64), text + start);
+  return kind_index(kinds, name, strlen(name));
+}
+
+// Labels every byte with its innermost command or tactic, then counts each
+// node towards the label of its first byte.
+static void label_tree(TSTree *tree, const char *text, uint32_t length,
+                       uint32_t *labels, Kinds *kinds) {
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    const char *type = ts_node_type(node);
+    if (ts_tree_cursor_current_depth(&cursor) == 1 &&
+        strcmp(type, "command") == 0)
+      label_range(labels, node, command_kind(node, kinds), kinds);
+    else if (strcmp(type, "tactic_p") == 0)
+      label_range(labels, node, tactic_kind(node, text, kinds), kinds);
+
+    if (ts_tree_cursor_goto_first_child(&cursor))
+      continue;
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor))
+        goto done;
+    }
+  }
+
+done:
+  // nodes are attributed once all labels are final, as tactics relabel the
+  // bytes of the command they are in
+  ts_tree_cursor_reset(&cursor, ts_tree_root_node(tree));
+  for (;;) {
+    uint32_t start = ts_node_start_byte(ts_tree_cursor_current_node(&cursor));
+    kinds->contents[start < length ? labels[start] : 0].nodes++;
+    if (ts_tree_cursor_goto_first_child(&cursor))
+      continue;
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return;
+      }
+    }
+  }
+}
+
+// timing pass
+
+typedef struct {
+  const char *text;
+  uint32_t length;
+} StringInput;
+
+static const char *read_string(void *payload, uint32_t byte_index,
+                               TSPoint position, uint32_t *bytes_read) {
+  const StringInput *self = payload;
+  (void)position;
+  if (byte_index >= self->length) {
+    *bytes_read = 0;
+    return "";
+  }
+  *bytes_read = self->length - byte_index;
+  return self->text + byte_index;
+}
+
+static bool record_sample(TSParseState *state) {
+  Timer *timer = state->payload;
+  double t = now();
+  Sample sample = {state->current_byte_offset, t - timer->last};
+  array_push(&timer->samples, sample);
+  timer->last = t;
+  return false;
+}
+
+// Spreads the time spent between two samples evenly over the bytes the parser
+// went through meanwhile.
+static void attribute_time(Kinds *kinds, const uint32_t *labels,
+                           uint32_t length, uint32_t from, uint32_t to,
+                           double time) {
+  if (!length)
+    return;
+  if (to > length)
+    to = length;
+  if (to <= from) {
+    kinds->contents[labels[to < length ? to : length - 1]].time += time;
+    return;
+  }
+  double per_byte = time / (to - from);
+  for (uint32_t i = from; i < to; i++)
+    kinds->contents[labels[i]].time += per_byte;
+}
+
+// Samples with this offset mark the end of a parse.
+#define END_OF_PARSE UINT32_MAX
+
+static void attribute_samples(Kinds *kinds, const uint32_t *labels,
+                              uint32_t length, const Timer *timer) {
+  uint32_t previous = 0;
+  for (uint32_t i = 0; i < timer->samples.size; i++) {
+    const Sample *sample = &timer->samples.contents[i];
+    if (sample->offset == END_OF_PARSE) {
+      attribute_time(kinds, labels, length, previous, length, sample->time);
+      previous = 0;
+    } else {
+      attribute_time(kinds, labels, length, previous, sample->offset,
+                     sample->time);
+      if (sample->offset > previous)
+        previous = sample->offset;
+    }
+  }
+}
+
+// counting pass
+
+// Counts calls to `scan` towards the byte the lexer has reached.
+static void count_scan(void *payload, LeanScannerCall call) {
+  Counter *self = payload;
+  if (call == LEAN_SCANNER_SCAN && self && self->position < self->length)
+    self->kinds->contents[self->labels[self->position]].scans++;
+}
+
+static const char *read_character(void *payload, uint32_t byte_index,
+                                  TSPoint position, uint32_t *bytes_read) {
+  Counter *self = payload;
+  (void)position;
+  if (byte_index >= self->length) {
+    *bytes_read = 0;
+    return "";
+  }
+
+  // a whole UTF-8 sequence, as the lexer can't decode a partial one
+  unsigned char c = (unsigned char)self->text[byte_index];
+  uint32_t size = c < 0xc0 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+  if (size > self->length - byte_index)
+    size = self->length - byte_index;
+
+  self->position = byte_index;
+  self->kinds->contents[self->labels[byte_index]].chars++;
+  *bytes_read = size;
+  return self->text + byte_index;
+}
+
+// report
+
+static int sort_column;
+
+static double column_value(const Kind *kind) {
+  switch (sort_column) {
+  case 1:
+    return (double)kind->bytes;
+  case 2:
+    return (double)kind->chars;
+  case 3:
+    return (double)kind->scans;
+  case 4:
+    return (double)kind->nodes;
+  default:
+    return kind->time;
+  }
+}
+
+static int compare_kinds(const void *a, const void *b) {
+  double x = column_value(a), y = column_value(b);
+  return x < y ? 1 : x > y ? -1 : 0;
+}
+
+static void print_report(Kinds *kinds, unsigned iterations) {
+  Kind total = {.name = "total"};
+  for (uint32_t i = 0; i < kinds->size; i++) {
+    const Kind *kind = &kinds->contents[i];
+    total.count += kind->count;
+    total.bytes += kind->bytes;
+    total.chars += kind->chars;
+    total.scans += kind->scans;
+    total.nodes += kind->nodes;
+    total.time += kind->time;
+  }
+
+  qsort(kinds->contents, kinds->size, sizeof(Kind), compare_kinds);
+  printf("%-40s %8s %10s %10s %6s %10s %10s %10s\n", "kind", "count", "bytes",
+         "time(ms)", "time%", "chars", "scans", "nodes");
+  for (uint32_t i = 0; i <= kinds->size; i++) {
+    const Kind *kind = i < kinds->size ? &kinds->contents[i] : &total;
+    printf("%-40s %8llu %10llu %10.3f %6.1f %10llu %10llu %10llu\n", kind->name,
+           (unsigned long long)kind->count, (unsigned long long)kind->bytes,
+           kind->time * 1e3 / iterations,
+           total.time > 0 ? 100 * kind->time / total.time : 0.0,
+           (unsigned long long)kind->chars, (unsigned long long)kind->scans,
+           (unsigned long long)kind->nodes);
+  }
+}
+
+int main(int argc, char **argv) {
+  static const char *const columns[] = {"time", "bytes", "chars", "scans",
+                                        "nodes"};
+  unsigned iterations = 1;
+  int first = 1;
+  for (; first + 1 < argc; first += 2) {
+    if (strcmp(argv[first], "-n") == 0) {
+      iterations = (unsigned)strtoul(argv[first + 1], NULL, 10);
+      if (!iterations)
+        iterations = 1;
+    } else if (strcmp(argv[first], "-s") == 0) {
+      sort_column = -1;
+      for (int i = 0; i < 5; i++) {
+        if (strcmp(argv[first + 1], columns[i]) == 0)
+          sort_column = i;
+      }
+      if (sort_column < 0)
+        first = argc;
+    } else {
+      break;
+    }
+  }
+  if (first >= argc) {
+    fprintf(stderr,
+            "usage: %s [-n iterations] [-s time|bytes|chars|scans|nodes] "
+            "path...\n",
+            argv[0]);
+    return 2;
+  }
+
+  LeanPaths paths = array_new();
+  for (int i = first; i < argc; i++)
+    lean_collect_files(argv[i], &paths);
+
+  // the same language, with the external scanner wrapped for counting
+  LeanScannerHooks hooks = {.enter = count_scan};
+  const TSLanguage *counting_language = lean_hooked_language(&hooks);
+
+  TSParser *parser = ts_parser_new();
+  TSParser *counting_parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_lean());
+  ts_parser_set_language(counting_parser, counting_language);
+
+  Kinds kinds = array_new();
+  kind_index(&kinds, "(other)", 7);
+
+  for (uint32_t f = 0; f < paths.size; f++) {
+    const char *path = paths.contents[f];
+    uint32_t length;
+    char *text = lean_read_file(path, &length);
+    if (!text) {
+      perror(path);
+      continue;
+    }
+
+    StringInput string = {text, length};
+    TSInput input = {.payload = &string,
+                     .read = read_string,
+                     .encoding = TSInputEncodingUTF8};
+    Timer timer = {0};
+    TSParseOptions options = {.payload = &timer,
+                              .progress_callback = record_sample};
+    TSTree *tree = NULL;
+    for (unsigned it = 0; it < iterations; it++) {
+      ts_tree_delete(tree);
+      timer.last = now();
+      tree = ts_parser_parse_with_options(parser, NULL, input, options);
+      Sample end = {END_OF_PARSE, now() - timer.last};
+      array_push(&timer.samples, end);
+    }
+
+    uint32_t *labels = calloc(length ? length : 1, sizeof(uint32_t));
+    label_tree(tree, text, length, labels, &kinds);
+    for (uint32_t i = 0; i < length; i++)
+      kinds.contents[labels[i]].bytes++;
+    attribute_samples(&kinds, labels, length, &timer);
+    array_delete(&timer.samples);
+    ts_tree_delete(tree);
+
+    Counter count = {text, length, 0, labels, &kinds};
+    TSInput counting_input = {.payload = &count,
+                              .read = read_character,
+                              .encoding = TSInputEncodingUTF8};
+    hooks.payload = &count;
+    ts_tree_delete(ts_parser_parse(counting_parser, NULL, counting_input));
+    hooks.payload = NULL;
+
+    free(labels);
+    free(text);
+  }
+
+  print_report(&kinds, iterations);
+
+  for (uint32_t i = 0; i < kinds.size; i++)
+    free(kinds.contents[i].name);
+  array_delete(&kinds);
+  ts_parser_delete(parser);
+  ts_parser_delete(counting_parser);
+  lean_paths_delete(&paths);
+  return 0;
+}
@@ -0,0 +1,462 @@
+// An editor daemon that keeps one incremental tree per open Lean document.
+//
+// It speaks a subset of LSP over stdio (JSON-RPC with Content-Length framing),
+// so that the formatter, linter and highlighter can share a single parse:
+//
+//   initialize, shutdown, exit
+//   textDocument/didOpen, textDocument/didChange, textDocument/didClose
+//   textDocument/documentSymbol
+//
+// Every didOpen and didChange is answered with a `lean/treeChanged`
+// notification carrying only what changed: the ranges whose syntax differs
+// from the previous tree, the current syntax errors and the outline.
+//
+// Positions count `character` in UTF-8 bytes (the `utf-8` positionEncoding of
+// LSP 3.17), which is what tree-sitter points use natively, when the client
+// offers it in `general.positionEncodings`, and in UTF-16 code units (the
+// default that every client supports) otherwise.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "json.h"
+#include "outline.h"
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  char *uri;
+  Array(char) text;
+  int64_t version;
+  TSTree *tree;
+} Document;
+
+typedef struct {
+  TSParser *parser;
+  // editors keep a handful of documents open, a linear scan is enough
+  Array(Document) documents;
+  // whether `character` counts UTF-16 code units rather than bytes
+  bool utf16;
+  bool shutdown;
+} Server;
+
+// LSP message framing
+
+static char *read_message(FILE *in, size_t *length) {
+  char line[256];
+  long content_length = -1;
+  for (;;) {
+    if (!fgets(line, sizeof(line), in))
+      return NULL;
+    if (strcmp(line, "\r\n") == 0 || strcmp(line, "\n") == 0)
+      break;
+    if (strncmp(line, "Content-Length:", 15) == 0)
+      content_length = strtol(line + 15, NULL, 10);
+  }
+  if (content_length < 0)
+    return NULL;
+
+  char *body = malloc((size_t)content_length + 1);
+  if (!body)
+    return NULL;
+  if (fread(body, 1, (size_t)content_length, in) != (size_t)content_length) {
+    free(body);
+    return NULL;
+  }
+  body[content_length] = '\0';
+  *length = (size_t)content_length;
+  return body;
+}
+
+static void write_message(FILE *out, const JsonBuffer *body) {
+  fprintf(out, "Content-Length: %u\r\n\r\n", body->size);
+  fwrite(body->contents, 1, body->size, out);
+  fflush(out);
+}
+
+// JSON helpers
+
+static const char *get_string(const JsonValue *object, const char *key) {
+  const JsonValue *value = json_get(object, key);
+  return value && value->type == JSON_STRING ? value->string : NULL;
+}
+
+static uint32_t get_uint(const JsonValue *object, const char *key) {
+  const JsonValue *value = json_get(object, key);
+  return value && value->type == JSON_NUMBER && value->number > 0
+             ? (uint32_t)value->number
+             : 0;
+}
+
+// The number of UTF-16 code units encoding `length` bytes of UTF-8: one per
+// sequence, and two for the 4-byte sequences outside the BMP.
+static uint32_t utf16_length(const char *text, uint32_t length) {
+  uint32_t units = 0;
+  for (uint32_t i = 0; i < length; i++) {
+    unsigned char c = (unsigned char)text[i];
+    if ((c & 0xc0) != 0x80)
+      units += c >= 0xf0 ? 2 : 1;
+  }
+  return units;
+}
+
+// Writes the position of `byte`, which is at `point` in `document`.
+static void write_point(JsonBuffer *out, const Server *server,
+                        const Document *document, TSPoint point,
+                        uint32_t byte) {
+  uint32_t character = point.column;
+  if (server->utf16 && byte >= point.column && byte <= document->text.size)
+    character = utf16_length(document->text.contents + byte - point.column,
+                             point.column);
+  json_printf(out, "{\"line\":%u,\"character\":%u}", point.row, character);
+}
+
+static void write_range(JsonBuffer *out, const Server *server,
+                        const Document *document, TSRange range) {
+  json_printf(out, "{\"start\":");
+  write_point(out, server, document, range.start_point, range.start_byte);
+  json_printf(out, ",\"end\":");
+  write_point(out, server, document, range.end_point, range.end_byte);
+  json_printf(out, "}");
+}
+
+static void write_response_start(JsonBuffer *out, const JsonValue *id) {
+  json_printf(out, "{\"jsonrpc\":\"2.0\",\"id\":");
+  if (id && id->type == JSON_STRING)
+    json_write_string(out, id->string, id->length);
+  else if (id && id->type == JSON_NUMBER)
+    json_printf(out, "%.0f", id->number);
+  else
+    json_printf(out, "null");
+}
+
+// documents
+
+static Document *find_document(Server *server, const char *uri) {
+  for (uint32_t i = 0; i < server->documents.size; i++) {
+    Document *document = array_get(&server->documents, i);
+    if (strcmp(document->uri, uri) == 0)
+      return document;
+  }
+  return NULL;
+}
+
+// Converts an LSP position into a byte offset and a tree-sitter point,
+// clamping it to the end of its line and of the document.
+static uint32_t resolve_position(const Server *server, const Document *document,
+                                 const JsonValue *position, TSPoint *point) {
+  uint32_t line = get_uint(position, "line");
+  uint32_t character = get_uint(position, "character");
+  const char *text = document->text.contents;
+  uint32_t length = document->text.size;
+
+  uint32_t offset = 0, row = 0;
+  while (row < line) {
+    const char *newline = memchr(text + offset, '\n', length - offset);
+    if (!newline)
+      break;
+    offset = (uint32_t)(newline - text) + 1;
+    row++;
+  }
+
+  uint32_t column = 0, units = 0;
+  while (units < character && offset + column < length &&
+         text[offset + column] != '\n') {
+    if (!server->utf16) {
+      units++;
+      column++;
+      continue;
+    }
+    // a position inside a surrogate pair moves past the whole character
+    units += (unsigned char)text[offset + column] >= 0xf0 ? 2 : 1;
+    do
+      column++;
+    while (offset + column < length &&
+           ((unsigned char)text[offset + column] & 0xc0) == 0x80);
+  }
+
+  *point = (TSPoint){row, column};
+  return offset + column;
+}
+
+static TSPoint advance_point(TSPoint point, const char *text, uint32_t length) {
+  for (uint32_t i = 0; i < length; i++) {
+    if (text[i] == '\n') {
+      point.row++;
+      point.column = 0;
+    } else {
+      point.column++;
+    }
+  }
+  return point;
+}
+
+// Applies one entry of `contentChanges` to the text, and to the tree so that
+// the next parse can reuse it.
+static void apply_change(const Server *server, Document *document,
+                         const JsonValue *change) {
+  const JsonValue *text = json_get(change, "text");
+  if (!text || text->type != JSON_STRING)
+    return;
+
+  const JsonValue *range = json_get(change, "range");
+  if (!range) {
+    array_clear(&document->text);
+    array_extend(&document->text, text->length, text->string);
+    ts_tree_delete(document->tree);
+    document->tree = NULL;
+    return;
+  }
+
+  TSInputEdit edit;
+  edit.start_byte = resolve_position(server, document,
+                                     json_get(range, "start"),
+                                     &edit.start_point);
+  edit.old_end_byte = resolve_position(server, document,
+                                       json_get(range, "end"),
+                                       &edit.old_end_point);
+  if (edit.old_end_byte < edit.start_byte) {
+    edit.old_end_byte = edit.start_byte;
+    edit.old_end_point = edit.start_point;
+  }
+  edit.new_end_byte = edit.start_byte + text->length;
+  edit.new_end_point =
+      advance_point(edit.start_point, text->string, text->length);
+
+  array_splice(&document->text, edit.start_byte,
+               edit.old_end_byte - edit.start_byte, text->length,
+               text->string);
+  if (document->tree)
+    ts_tree_edit(document->tree, &edit);
+}
+
+// Reparses a document and notifies the client of what changed.
+static void reparse(Server *server, Document *document, FILE *out) {
+  TSTree *old_tree = document->tree;
+  TSTree *tree = ts_parser_parse_string(
+      server->parser, old_tree,
+      document->text.size ? document->text.contents : "", document->text.size);
+  document->tree = tree;
+
+  JsonBuffer message = array_new();
+  json_printf(&message, "{\"jsonrpc\":\"2.0\",\"method\":\"lean/treeChanged\","
+                        "\"params\":{\"uri\":");
+  json_write_string(&message, document->uri, strlen(document->uri));
+  json_printf(&message, ",\"version\":%lld,\"changedRanges\":[",
+              (long long)document->version);
+
+  TSNode root = ts_tree_root_node(tree);
+  if (old_tree) {
+    uint32_t count;
+    TSRange *ranges = ts_tree_get_changed_ranges(old_tree, tree, &count);
+    for (uint32_t i = 0; i < count; i++) {
+      if (i)
+        json_printf(&message, ",");
+      write_range(&message, server, document, ranges[i]);
+    }
+    free(ranges);
+    ts_tree_delete(old_tree);
+  } else {
+    write_range(&message, server, document,
+                (TSRange){.end_point = ts_node_end_point(root),
+                          .end_byte = ts_node_end_byte(root)});
+  }
+
+  json_printf(&message, "],\"errors\":[");
+  LeanSyntaxErrors errors = array_new();
+  lean_syntax_errors_collect(root, &errors);
+  for (uint32_t i = 0; i < errors.size; i++) {
+    LeanSyntaxError *error = array_get(&errors, i);
+    json_printf(&message, "%s{\"range\":", i ? "," : "");
+    write_range(&message, server, document, error->range);
+    json_printf(&message, ",\"missing\":%s}",
+                error->missing ? "true" : "false");
+  }
+  array_delete(&errors);
+
+  json_printf(&message, "],\"outline\":[");
+  LeanOutline outline = array_new();
+  lean_outline_collect(root, &outline);
+  for (uint32_t i = 0; i < outline.size; i++) {
+    LeanOutlineItem *item = array_get(&outline, i);
+    json_printf(&message, "%s{\"kind\":\"%s\",\"name\":", i ? "," : "",
+                item->kind);
+    json_write_string(&message, document->text.contents + item->name.start_byte,
+                      item->name.end_byte - item->name.start_byte);
+    json_printf(&message, ",\"range\":");
+    write_range(&message, server, document, item->range);
+    json_printf(&message, ",\"selectionRange\":");
+    write_range(&message, server, document, item->name);
+    json_printf(&message, "}");
+  }
+  array_delete(&outline);
+
+  json_printf(&message, "]}}");
+  write_message(out, &message);
+  array_delete(&message);
+}
+
+static void close_document(Server *server, Document *document) {
+  free(document->uri);
+  array_delete(&document->text);
+  ts_tree_delete(document->tree);
+  array_erase(&server->documents,
+              (uint32_t)(document - server->documents.contents));
+}
+
+// LSP SymbolKind for an outline entry.
+static int symbol_kind(const char *kind) {
+  if (strcmp(kind, "cmd_namespace") == 0)
+    return 3;
+  if (strcmp(kind, "cmd_section") == 0 ||
+      strcmp(kind, "cmd_noncomputable_section") == 0)
+    return 2;
+  if (strcmp(kind, "structure") == 0)
+    return 23;
+  if (strcmp(kind, "inductive") == 0 || strcmp(kind, "class_inductive") == 0)
+    return 10;
+  if (strcmp(kind, "theorem") == 0 || strcmp(kind, "axiom") == 0)
+    return 14;
+  if (strcmp(kind, "instance") == 0)
+    return 5;
+  return 12;
+}
+
+static void document_symbols(const Server *server, Document *document,
+                             const JsonValue *id, FILE *out) {
+  JsonBuffer message = array_new();
+  write_response_start(&message, id);
+  json_printf(&message, ",\"result\":[");
+
+  LeanOutline outline = array_new();
+  if (document && document->tree)
+    lean_outline_collect(ts_tree_root_node(document->tree), &outline);
+  for (uint32_t i = 0; i < outline.size; i++) {
+    LeanOutlineItem *item = array_get(&outline, i);
+    json_printf(&message, "%s{\"name\":", i ? "," : "");
+    if (item->name.end_byte > item->name.start_byte)
+      json_write_string(&message,
+                        document->text.contents + item->name.start_byte,
+                        item->name.end_byte - item->name.start_byte);
+    else
+      json_write_string(&message, item->kind, strlen(item->kind));
+    json_printf(&message, ",\"detail\":\"%s\",\"kind\":%d,\"range\":",
+                item->kind, symbol_kind(item->kind));
+    write_range(&message, server, document, item->range);
+    json_printf(&message, ",\"selectionRange\":");
+    write_range(&message, server, document,
+                item->name.end_byte > item->name.start_byte ? item->name
+                                                            : item->range);
+    json_printf(&message, "}");
+  }
+  array_delete(&outline);
+
+  json_printf(&message, "]}");
+  write_message(out, &message);
+  array_delete(&message);
+}
+
+// Handles one message, returning false once the server should exit.
+static bool handle(Server *server, const JsonValue *request, FILE *out) {
+  const char *method = get_string(request, "method");
+  const JsonValue *id = json_get(request, "id");
+  const JsonValue *params = json_get(request, "params");
+  const JsonValue *text_document = json_get(params, "textDocument");
+  const char *uri = get_string(text_document, "uri");
+  if (!method)
+    return true;
+
+  JsonBuffer message = array_new();
+
+  if (strcmp(method, "initialize") == 0) {
+    const JsonValue *encodings = json_get(
+        json_get(json_get(params, "capabilities"), "general"),
+        "positionEncodings");
+    server->utf16 = true;
+    if (encodings && encodings->type == JSON_ARRAY)
+      for (const JsonValue *e = encodings->child; e; e = e->next)
+        if (e->type == JSON_STRING && strcmp(e->string, "utf-8") == 0)
+          server->utf16 = false;
+    write_response_start(&message, id);
+    json_printf(&message,
+                ",\"result\":{\"capabilities\":{\"positionEncoding\":\"%s\","
+                "\"textDocumentSync\":{\"openClose\":true,\"change\":2},"
+                "\"documentSymbolProvider\":true},"
+                "\"serverInfo\":{\"name\":\"tree-sitter-lean-server\"}}}",
+                server->utf16 ? "utf-16" : "utf-8");
+  } else if (strcmp(method, "shutdown") == 0) {
+    server->shutdown = true;
+    write_response_start(&message, id);
+    json_printf(&message, ",\"result\":null}");
+  } else if (strcmp(method, "exit") == 0) {
+    return false;
+  } else if (strcmp(method, "textDocument/didOpen") == 0 && uri) {
+    const JsonValue *text = json_get(text_document, "text");
+    Document *document = find_document(server, uri);
+    if (document)
+      close_document(server, document);
+    Document opened = {.uri = strdup(uri),
+                       .version = get_uint(text_document, "version")};
+    if (text && text->type == JSON_STRING)
+      array_extend(&opened.text, text->length, text->string);
+    array_push(&server->documents, opened);
+    reparse(server, array_back(&server->documents), out);
+  } else if (strcmp(method, "textDocument/didChange") == 0 && uri) {
+    Document *document = find_document(server, uri);
+    const JsonValue *changes = json_get(params, "contentChanges");
+    if (document && changes && changes->type == JSON_ARRAY) {
+      for (const JsonValue *c = changes->child; c; c = c->next)
+        apply_change(server, document, c);
+      document->version = get_uint(text_document, "version");
+      reparse(server, document, out);
+    }
+  } else if (strcmp(method, "textDocument/didClose") == 0 && uri) {
+    Document *document = find_document(server, uri);
+    if (document)
+      close_document(server, document);
+  } else if (strcmp(method, "textDocument/documentSymbol") == 0 && id) {
+    document_symbols(server, uri ? find_document(server, uri) : NULL, id, out);
+  } else if (id) {
+    write_response_start(&message, id);
+    json_printf(&message, ",\"error\":{\"code\":-32601,"
+                          "\"message\":\"method not found\"}}");
+  }
+
+  if (message.size)
+    write_message(out, &message);
+  array_delete(&message);
+  return true;
+}
+
+int main(void) {
+  Server server = {.parser = ts_parser_new(), .utf16 = true};
+  ts_parser_set_language(server.parser, tree_sitter_lean());
+
+  size_t length;
+  char *body;
+  bool running = true;
+  while (running && (body = read_message(stdin, &length))) {
+    JsonValue *request = json_parse(body, length);
+    if (request) {
+      running = handle(&server, request, stdout);
+      json_free(request);
+    } else {
+      JsonBuffer message = array_new();
+      json_printf(&message, "{\"jsonrpc\":\"2.0\",\"id\":null,\"error\":"
+                            "{\"code\":-32700,\"message\":\"parse error\"}}");
+      write_message(stdout, &message);
+      array_delete(&message);
+    }
+    free(body);
+  }
+
+  while (server.documents.size)
+    close_document(&server, array_front(&server.documents));
+  array_delete(&server.documents);
+  ts_parser_delete(server.parser);
+  return server.shutdown ? 0 : 1;
+}
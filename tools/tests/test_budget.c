@@ -0,0 +1,109 @@
+// Tests of lean_parse_with_budget (see budget.h): each fallback, and
+// cancellation through a flag set before the call.
+//
+// usage: test_budget
+//
+// The parser only checks its budget every hundred or so operations, so the
+// source is made long enough for every parse to get there.
+
+#include "budget.h"
+
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures;
+
+#define check(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+#define COMMANDS 500
+
+// A header, then COMMANDS two-line definitions.
+static char *make_source(uint32_t *length) {
+  size_t capacity = 64 + COMMANDS * 64, size = 0;
+  char *source = malloc(capacity);
+  size += (size_t)snprintf(source, capacity, "import Foo.Bar\n\n");
+  for (unsigned i = 0; i < COMMANDS; i++)
+    size += (size_t)snprintf(source + size, capacity - size,
+                             "def f%u (x : Nat) : Nat :=\n  x + %u\n\n", i, i);
+  *length = (uint32_t)size;
+  return source;
+}
+
+static uint32_t nodes(TSTree *tree) {
+  return ts_node_descendant_count(ts_tree_root_node(tree));
+}
+
+static uint32_t included_ranges(TSTree *tree) {
+  uint32_t count;
+  free(ts_tree_included_ranges(tree, &count));
+  return count;
+}
+
+int main(void) {
+  uint32_t length;
+  char *source = make_source(&length);
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_lean());
+  LeanParseMode mode;
+
+  // no budget: a full parse
+  LeanParseBudget budget = {0};
+  TSTree *full = lean_parse_with_budget(parser, source, length, &budget, &mode);
+  check(full && mode == LEAN_PARSE_FULL);
+  check(full && !ts_node_has_error(ts_tree_root_node(full)));
+  check(full && included_ranges(full) == 1);
+
+  // a file over the size budget: the header and the first line of each
+  // command, one included range each
+  budget.bytes = length - 1;
+  TSTree *tree = lean_parse_with_budget(parser, source, length, &budget, &mode);
+  check(tree && mode == LEAN_PARSE_SKELETON);
+  check(tree && included_ranges(tree) == 1 + COMMANDS);
+  ts_tree_delete(tree);
+  budget.bytes = length;
+  tree = lean_parse_with_budget(parser, source, length, &budget, &mode);
+  check(tree && mode == LEAN_PARSE_FULL);
+  ts_tree_delete(tree);
+
+  // a time budget no parse of this size can meet: the header, which isn't
+  // limited
+  budget = (LeanParseBudget){.time_micros = 1};
+  tree = lean_parse_with_budget(parser, source, length, &budget, &mode);
+  check(tree && mode == LEAN_PARSE_HEADER);
+  check(tree && ts_node_end_byte(ts_tree_root_node(tree)) < length / 2);
+  ts_tree_delete(tree);
+
+  // cancelled before the call, with and without the fallbacks in play: no
+  // tree and no fallback
+  size_t flag = 1;
+  budget = (LeanParseBudget){.cancellation_flag = &flag};
+  tree = lean_parse_with_budget(parser, source, length, &budget, &mode);
+  check(!tree && mode == LEAN_PARSE_CANCELLED);
+  budget.bytes = 1;
+  tree = lean_parse_with_budget(parser, source, length, &budget, &mode);
+  check(!tree && mode == LEAN_PARSE_CANCELLED);
+
+  // the cancelled parse is not resumed by the next one
+  flag = 0;
+  budget.bytes = 0;
+  tree = lean_parse_with_budget(parser, source, length, &budget, &mode);
+  check(tree && mode == LEAN_PARSE_FULL);
+  check(tree && full && nodes(tree) == nodes(full));
+  ts_tree_delete(tree);
+
+  ts_tree_delete(full);
+  ts_parser_delete(parser);
+  free(source);
+  if (failures)
+    fprintf(stderr, "%d failed checks\n", failures);
+  return failures != 0;
+}
@@ -0,0 +1,236 @@
+// Tests of the binary event encoding of events.h: events pushed into a ring
+// buffer, read out in odd-sized chunks and decoded must come back unchanged.
+// The events are made up, so no parser or tree is involved.
+//
+// usage: test_events
+
+#include "events.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures;
+
+#define check(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static LeanEvent enter(TSSymbol symbol, TSFieldId field, bool named,
+                       uint32_t start, uint32_t end) {
+  return (LeanEvent){false, named, symbol, field, start, end};
+}
+
+// A leave event as the decoder returns it: its enter event with `leave` set.
+static LeanEvent leave(LeanEvent event) {
+  event.leave = true;
+  return event;
+}
+
+static bool same(const LeanEvent *a, const LeanEvent *b) {
+  return a->leave == b->leave && a->named == b->named &&
+         a->symbol == b->symbol && a->field == b->field &&
+         a->start_byte == b->start_byte && a->end_byte == b->end_byte;
+}
+
+// A well-nested stream with every flag combination, the largest symbol and
+// field, offsets near UINT32_MAX and starts that go back (a leave followed by
+// an earlier sibling can't happen in a tree, but the encoding allows it).
+static uint32_t make_events(LeanEvent *events) {
+  LeanEvent root = enter(1, 0, true, 0, UINT32_MAX);
+  LeanEvent a = enter(2, 3, true, 10, 20);
+  LeanEvent b = enter(UINT16_MAX, 0, false, 20, 21);
+  LeanEvent c = enter(7, UINT16_MAX, true, UINT32_MAX - 5, UINT32_MAX);
+  LeanEvent d = enter(8, 1, false, UINT32_MAX, UINT32_MAX);
+  LeanEvent e = enter(9, 0, true, 5, 6);
+  uint32_t n = 0;
+  events[n++] = root;
+  events[n++] = a;
+  events[n++] = b;
+  events[n++] = leave(b);
+  events[n++] = leave(a);
+  events[n++] = c;
+  events[n++] = d;
+  events[n++] = leave(d);
+  events[n++] = leave(c);
+  events[n++] = e;
+  events[n++] = leave(e);
+  for (uint32_t i = 0; i < 200; i++) {
+    LeanEvent leaf = enter(3 + i % 5, i % 3, i % 2, 1000 + 7 * i, 1003 + 7 * i);
+    events[n++] = leaf;
+    events[n++] = leave(leaf);
+  }
+  events[n++] = leave(root);
+  return n;
+}
+
+#define MAX_EVENTS 512
+
+// Decodes `stream` and compares it with `events`. The stream is handed over
+// in chunks of `chunk` bytes, as a reader of the ring would get it, so that
+// events are split across reads.
+static void check_decode(const uint8_t *stream, uint32_t size,
+                         const LeanEvent *events, uint32_t count,
+                         uint32_t chunk) {
+  LeanEventDecoder decoder;
+  lean_event_decoder_init(&decoder);
+  uint32_t decoded = 0, offset = 0, available = 0;
+  while (offset < size) {
+    if (available < size)
+      available = available + chunk < size ? available + chunk : size;
+    LeanEvent event;
+    int n = lean_event_decode(&decoder, stream + offset, available - offset,
+                              &event);
+    check(n >= 0);
+    if (n < 0)
+      break;
+    if (n == 0) {
+      // a truncated event is only possible before the end of the stream
+      check(available < size);
+      if (available == size)
+        break;
+      continue;
+    }
+    check(decoded < count && same(&event, &events[decoded]));
+    decoded++;
+    offset += n;
+  }
+  check(decoded == count);
+  check(decoder.open.size == 0);
+  lean_event_decoder_delete(&decoder);
+}
+
+// Pushes all events through a ring of `capacity` bytes, draining it `chunk`
+// bytes at a time whenever it is full, so that records wrap around its end.
+static uint32_t through_ring(const LeanEvent *events, uint32_t count,
+                             uint32_t capacity, uint32_t chunk,
+                             uint8_t *stream) {
+  LeanEventRing ring;
+  lean_event_ring_init(&ring, capacity);
+  uint32_t size = 0;
+  for (uint32_t i = 0; i < count;) {
+    if (lean_event_ring_push(&ring, &events[i])) {
+      i++;
+      continue;
+    }
+    uint32_t n = lean_event_ring_read(&ring, stream + size, chunk);
+    check(n > 0);
+    size += n;
+  }
+  uint32_t n;
+  while ((n = lean_event_ring_read(&ring, stream + size, chunk)))
+    size += n;
+  check(ring.size == 0);
+  lean_event_ring_delete(&ring);
+  return size;
+}
+
+static void test_round_trip(void) {
+  static LeanEvent events[MAX_EVENTS];
+  static uint8_t stream[MAX_EVENTS * LEAN_EVENT_MAX_SIZE];
+  static uint8_t expected[MAX_EVENTS * LEAN_EVENT_MAX_SIZE];
+  uint32_t count = make_events(events);
+
+  // a ring large enough for everything is the reference encoding
+  uint32_t size = through_ring(events, count, sizeof(expected), sizeof(expected),
+                               expected);
+  check(size > 0 && size < sizeof(expected));
+  check_decode(expected, size, events, count, size);
+
+  // rings just over the minimum, drained in sizes that don't divide them
+  uint32_t capacities[] = {LEAN_EVENT_MAX_SIZE, LEAN_EVENT_MAX_SIZE + 1,
+                           LEAN_EVENT_MAX_SIZE + 6, 64, 97};
+  uint32_t chunks[] = {1, 3, 5, 16, 1000};
+  for (size_t i = 0; i < sizeof(capacities) / sizeof(*capacities); i++) {
+    for (size_t j = 0; j < sizeof(chunks) / sizeof(*chunks); j++) {
+      uint32_t n = through_ring(events, count, capacities[i], chunks[j], stream);
+      check(n == size && memcmp(stream, expected, size) == 0);
+      check_decode(stream, n, events, count, chunks[j]);
+    }
+  }
+}
+
+// Every proper prefix of a record decodes to "need more", never to an event
+// or an error.
+static void test_truncated(void) {
+  LeanEvent events[] = {
+      enter(UINT16_MAX, UINT16_MAX, true, UINT32_MAX - 1, UINT32_MAX),
+      enter(1, 0, false, 0, 1),
+  };
+  for (size_t i = 0; i < 2; i++) {
+    LeanEventRing ring;
+    lean_event_ring_init(&ring, 64);
+    uint8_t record[LEAN_EVENT_MAX_SIZE];
+    // the second record's start is a large negative delta from the first's
+    if (i == 1) {
+      check(lean_event_ring_push(&ring, &events[0]));
+      lean_event_ring_read(&ring, record, sizeof(record));
+    }
+    check(lean_event_ring_push(&ring, &events[i]));
+    uint32_t size = lean_event_ring_read(&ring, record, sizeof(record));
+    lean_event_ring_delete(&ring);
+
+    for (uint32_t length = 0; length <= size; length++) {
+      LeanEventDecoder decoder;
+      lean_event_decoder_init(&decoder);
+      decoder.last_start = i == 1 ? events[0].start_byte : 0;
+      LeanEvent event;
+      int n = lean_event_decode(&decoder, record, length, &event);
+      if (length < size) {
+        check(n == 0);
+        check(decoder.open.size == 0);
+      } else {
+        check(n == (int)size && same(&event, &events[i]));
+      }
+      lean_event_decoder_delete(&decoder);
+    }
+  }
+}
+
+static void test_malformed(void) {
+  LeanEventDecoder decoder;
+  lean_event_decoder_init(&decoder);
+  LeanEvent event;
+
+  // a leave with nothing open
+  check(lean_event_decode(&decoder, (const uint8_t[]){0}, 1, &event) == -1);
+  // flag bytes without the enter bit, or with unknown bits
+  uint8_t flags[] = {2, 4, 6, 8, 9, 0x81, 0xff};
+  for (size_t i = 0; i < sizeof(flags); i++) {
+    uint8_t record[] = {flags[i], 1, 0, 1};
+    check(lean_event_decode(&decoder, record, sizeof(record), &event) == -1);
+  }
+  // a start before the beginning of the document
+  check(lean_event_decode(&decoder, (const uint8_t[]){1, 1, 1, 0}, 4, &event) ==
+        -1);
+  // a symbol that doesn't fit in a TSSymbol
+  check(lean_event_decode(&decoder, (const uint8_t[]){1, 0x80, 0x80, 4, 0, 0},
+                          6, &event) == -1);
+  // an end past UINT32_MAX
+  check(lean_event_decode(&decoder,
+                          (const uint8_t[]){1, 1, 0, 0xff, 0xff, 0xff, 0xff,
+                                            0x1f},
+                          8, &event) == -1);
+  // a varint still continued after 10 bytes, as the symbol and as the length
+  uint8_t record[16] = {1};
+  memset(record + 1, 0x80, 10);
+  check(lean_event_decode(&decoder, record, 11, &event) == -1);
+  memset(record + 1, 0, 2);
+  memset(record + 3, 0x80, 10);
+  check(lean_event_decode(&decoder, record, 13, &event) == -1);
+  check(decoder.open.size == 0);
+  lean_event_decoder_delete(&decoder);
+}
+
+int main(void) {
+  test_round_trip();
+  test_truncated();
+  test_malformed();
+  if (failures)
+    fprintf(stderr, "%d failed checks\n", failures);
+  return failures != 0;
+}
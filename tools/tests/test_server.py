@@ -0,0 +1,160 @@
+"""Scripted client for tree-sitter-lean-server.
+
+usage: python3 test_server.py path/to/tree-sitter-lean-server
+"""
+
+import json
+import subprocess
+import sys
+from unittest import TestCase, main
+
+SERVER = "tree-sitter-lean-server"
+URI = "file:///test.lean"
+
+
+class Client:
+    def __init__(self):
+        self.process = subprocess.Popen(
+            [SERVER], stdin=subprocess.PIPE, stdout=subprocess.PIPE
+        )
+        self.next_id = 0
+
+    def send(self, method, params=None, request=False):
+        message = {"jsonrpc": "2.0", "method": method}
+        if params is not None:
+            message["params"] = params
+        if request:
+            self.next_id += 1
+            message["id"] = self.next_id
+        body = json.dumps(message).encode()
+        self.process.stdin.write(b"Content-Length: %d\r\n\r\n" % len(body) + body)
+        self.process.stdin.flush()
+
+    def receive(self):
+        length = None
+        while (line := self.process.stdout.readline()) not in (b"\r\n", b""):
+            if line.startswith(b"Content-Length:"):
+                length = int(line.split(b":")[1])
+        return json.loads(self.process.stdout.read(length))
+
+    def request(self, method, params=None):
+        self.send(method, params, request=True)
+        return self.receive()
+
+    def close(self):
+        self.request("shutdown")
+        self.send("exit")
+        return self.process.wait(timeout=10)
+
+
+class TestServer(TestCase):
+    def setUp(self):
+        self.initialize({})
+
+    def initialize(self, capabilities):
+        self.client = Client()
+        response = self.client.request("initialize", {"capabilities": capabilities})
+        return response["result"]["capabilities"]["positionEncoding"]
+
+    def tearDown(self):
+        self.assertEqual(self.client.close(), 0)
+
+    def open(self, text):
+        self.client.send("textDocument/didOpen", {
+            "textDocument": {"uri": URI, "version": 1, "text": text},
+        })
+        return self.client.receive()["params"]
+
+    def change(self, version, start, end, text):
+        self.client.send("textDocument/didChange", {
+            "textDocument": {"uri": URI, "version": version},
+            "contentChanges": [{
+                "range": {
+                    "start": {"line": start[0], "character": start[1]},
+                    "end": {"line": end[0], "character": end[1]},
+                },
+                "text": text,
+            }],
+        })
+        return self.client.receive()["params"]
+
+    def test_default_encoding(self):
+        self.assertEqual(self.client.close(), 0)
+        self.assertEqual(self.initialize({}), "utf-16")
+
+    def test_outline(self):
+        params = self.open("namespace Foo\n\ntheorem bar : True := trivial\n\nend Foo\n")
+        self.assertEqual(params["errors"], [])
+        self.assertEqual(
+            [(item["kind"], item["name"]) for item in params["outline"]],
+            [("cmd_namespace", "Foo"), ("theorem", "bar")],
+        )
+
+    def test_incremental_edit(self):
+        self.open("def foo := 1\n\ndef bar := 2\n")
+        params = self.change(2, (2, 4), (2, 7), "baz")
+        self.assertEqual(params["version"], 2)
+        self.assertEqual([item["name"] for item in params["outline"]], ["foo", "baz"])
+        for r in params["changedRanges"]:
+            self.assertEqual(r["start"]["line"], 2)
+
+    def test_syntax_errors(self):
+        self.open("def foo := 1\n")
+        params = self.change(2, (0, 8), (0, 10), "")
+        self.assertNotEqual(params["errors"], [])
+        params = self.change(3, (0, 8), (0, 8), ":=")
+        self.assertEqual(params["errors"], [])
+
+    def test_document_symbol(self):
+        self.open("structure Point where\n  x : Nat\n")
+        response = self.client.request("textDocument/documentSymbol", {
+            "textDocument": {"uri": URI},
+        })
+        self.assertEqual([s["name"] for s in response["result"]], ["Point"])
+
+    def test_anonymous_command(self):
+        # an unnamed command is selected at its start, inside its range
+        params = self.open("def foo := 1\n\nexample : True := trivial\n")
+        item = params["outline"][1]
+        self.assertEqual((item["kind"], item["name"]), ("example", ""))
+        self.assertEqual(item["selectionRange"]["start"], item["range"]["start"])
+        self.assertEqual(item["selectionRange"]["end"], {"line": 2, "character": 0})
+        response = self.client.request("textDocument/documentSymbol", {
+            "textDocument": {"uri": URI},
+        })
+        symbol = response["result"][1]
+        self.assertEqual(symbol["name"], "example")
+        self.assertEqual(symbol["selectionRange"]["start"], {"line": 2, "character": 0})
+
+    def test_utf16_positions(self):
+        # α and β are one UTF-16 code unit but two bytes, 𝔸 is a surrogate pair
+        params = self.open('def αβ := "𝔸"\n\ndef 𝔸 := 2\n')
+        names = [item["selectionRange"] for item in params["outline"]]
+        self.assertEqual([(r["start"]["character"], r["end"]["character"]) for r in names],
+                         [(4, 6), (4, 6)])
+        params = self.change(2, (0, 4), (0, 6), "γ")
+        self.assertEqual([item["name"] for item in params["outline"]], ["γ", "𝔸"])
+        params = self.change(3, (0, 10), (0, 12), "x")
+        self.assertEqual(params["errors"], [])
+        params = self.change(4, (2, 4), (2, 6), "δ")
+        self.assertEqual([item["name"] for item in params["outline"]], ["γ", "δ"])
+
+    def test_utf8_positions(self):
+        self.assertEqual(self.client.close(), 0)
+        encoding = self.initialize({"general": {"positionEncodings": ["utf-8", "utf-16"]}})
+        self.assertEqual(encoding, "utf-8")
+        params = self.open("def αβ := 1\n")
+        name = params["outline"][0]["selectionRange"]
+        self.assertEqual((name["start"]["character"], name["end"]["character"]), (4, 8))
+        params = self.change(2, (0, 4), (0, 8), "γ")
+        self.assertEqual([item["name"] for item in params["outline"]], ["γ"])
+
+    def test_unknown_request(self):
+        response = self.client.request("textDocument/hover", {})
+        self.assertEqual(response["error"]["code"], -32601)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) > 1:
+        SERVER = sys.argv.pop(1)
+    main()
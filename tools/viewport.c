@@ -0,0 +1,194 @@
+// Measures latency to first highlight with and without viewport parsing.
+//
+// usage: tree-sitter-lean-viewport [-n iterations] [-l lines] path...
+//
+// For viewports of `lines` lines (default 60) at the start, middle and near
+// the end of each file, the time until the visible nodes are known is taken
+// both ways: through tree_sitter_lean_parse_viewport and through a parse of
+// the whole file. Either way, that time covers the parse plus a walk that
+// collects the named nodes overlapping the viewport, which is what a
+// highlighter needs.
+//
+// It also reports how many of the visible nodes in the viewport tree match
+// the full tree (same kind and bytes), i.e. how usable the first highlight
+// is before the full parse replaces it. Times are the best of `iterations`
+// runs (default 5).
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "files.h"
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-lean-input.h>
+#include <tree_sitter/tree-sitter-lean.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+  TSSymbol symbol;
+  uint32_t start_byte;
+  uint32_t end_byte;
+} VisibleNode;
+
+typedef Array(VisibleNode) VisibleNodes;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Collects the named nodes overlapping [start, end), in pre-order, skipping
+// subtrees that don't.
+static void collect_visible(TSTree *tree, uint32_t start, uint32_t end,
+                            VisibleNodes *nodes) {
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    bool visible =
+        ts_node_start_byte(node) < end && ts_node_end_byte(node) > start;
+    if (visible && ts_node_is_named(node)) {
+      VisibleNode v = {ts_node_symbol(node), ts_node_start_byte(node),
+                       ts_node_end_byte(node)};
+      array_push(nodes, v);
+    }
+    if (visible && ts_tree_cursor_goto_first_child(&cursor))
+      continue;
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return;
+      }
+    }
+  }
+}
+
+static int compare_nodes(const void *a, const void *b) {
+  const VisibleNode *x = a, *y = b;
+  if (x->start_byte != y->start_byte)
+    return x->start_byte < y->start_byte ? -1 : 1;
+  if (x->end_byte != y->end_byte)
+    return x->end_byte > y->end_byte ? -1 : 1;
+  return (int)x->symbol - (int)y->symbol;
+}
+
+// The number of nodes of `a` also in `b`; both are sorted.
+static uint32_t count_matching(VisibleNodes *a, VisibleNodes *b) {
+  uint32_t matching = 0;
+  for (uint32_t i = 0, j = 0; i < a->size && j < b->size;) {
+    int order = compare_nodes(&a->contents[i], &b->contents[j]);
+    if (order == 0)
+      matching++;
+    if (order <= 0)
+      i++;
+    if (order >= 0)
+      j++;
+  }
+  return matching;
+}
+
+// The byte offset of the start of line `row`, or `length` past the end.
+static uint32_t line_offset(const char *text, uint32_t length, uint32_t row) {
+  uint32_t offset = 0;
+  for (; row > 0; row--) {
+    const char *newline = memchr(text + offset, '\n', length - offset);
+    if (!newline)
+      return length;
+    offset = (uint32_t)(newline - text) + 1;
+  }
+  return offset;
+}
+
+int main(int argc, char **argv) {
+  unsigned iterations = 5, lines = 60;
+  int first = 1;
+  for (; first + 1 < argc; first += 2) {
+    if (strcmp(argv[first], "-n") == 0)
+      iterations = (unsigned)strtoul(argv[first + 1], NULL, 10);
+    else if (strcmp(argv[first], "-l") == 0)
+      lines = (unsigned)strtoul(argv[first + 1], NULL, 10);
+    else
+      break;
+  }
+  if (!iterations)
+    iterations = 1;
+  if (!lines)
+    lines = 1;
+  if (first >= argc) {
+    fprintf(stderr, "usage: %s [-n iterations] [-l lines] path...\n", argv[0]);
+    return 2;
+  }
+
+  LeanPaths paths = array_new();
+  for (int i = first; i < argc; i++)
+    lean_collect_files(argv[i], &paths);
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_lean());
+  VisibleNodes full_nodes = array_new(), viewport_nodes = array_new();
+
+  for (uint32_t f = 0; f < paths.size; f++) {
+    const char *path = paths.contents[f];
+    uint32_t length;
+    char *text = lean_read_file(path, &length);
+    if (!text) {
+      perror(path);
+      continue;
+    }
+    uint32_t line_count = 1;
+    for (uint32_t i = 0; i < length; i++)
+      line_count += text[i] == '\n';
+
+    static const double positions[] = {0, 0.5, 0.9};
+    for (size_t p = 0; p < sizeof(positions) / sizeof(*positions); p++) {
+      uint32_t row = (uint32_t)(positions[p] * line_count);
+      uint32_t start = line_offset(text, length, row);
+      uint32_t end = line_offset(text, length, row + lines);
+
+      double full_time = 1e9, viewport_time = 1e9;
+      TSRange window = {0};
+      for (unsigned it = 0; it < iterations; it++) {
+        array_clear(&full_nodes);
+        double t = now();
+        TSTree *tree = ts_parser_parse_string(parser, NULL, text, length);
+        collect_visible(tree, start, end, &full_nodes);
+        t = now() - t;
+        if (t < full_time)
+          full_time = t;
+        ts_tree_delete(tree);
+
+        array_clear(&viewport_nodes);
+        t = now();
+        tree = tree_sitter_lean_parse_viewport(parser, text, length, start,
+                                               end - start, &window);
+        collect_visible(tree, start, end, &viewport_nodes);
+        t = now() - t;
+        if (t < viewport_time)
+          viewport_time = t;
+        ts_tree_delete(tree);
+      }
+
+      qsort(full_nodes.contents, full_nodes.size, sizeof(VisibleNode),
+            compare_nodes);
+      qsort(viewport_nodes.contents, viewport_nodes.size, sizeof(VisibleNode),
+            compare_nodes);
+      uint32_t matching = count_matching(&viewport_nodes, &full_nodes);
+      printf("%s:%u: parsed %u of %u bytes in %.3f ms, whole file %.3f ms "
+             "(%.1fx), %u/%u visible nodes match (%.1f%%)\n",
+             path, row + 1, window.end_byte - window.start_byte, length,
+             viewport_time * 1e3, full_time * 1e3, full_time / viewport_time,
+             matching, full_nodes.size,
+             full_nodes.size ? 100.0 * matching / full_nodes.size : 100.0);
+    }
+    free(text);
+  }
+
+  array_delete(&full_nodes);
+  array_delete(&viewport_nodes);
+  ts_parser_delete(parser);
+  lean_paths_delete(&paths);
+  return 0;
+}